@@ -217,31 +217,41 @@ function applyStatusTint(status = "") {
 }
 
 /**
- * Convert date/time strings into a JS Date object for sorting.
+ * Convert a record's timestamp into a JS Date object.
  * Works with:
- * date = "2026-02-21"
- * time = "1:07:04 PM"
+ * ts = 1771707424000            (epoch ms, current firmware)
+ * date = "2026-02-21", time = "1:07:04 PM"   (older records)
+ * Returns null if the record has no usable time (e.g. clock not synced yet).
  */
-function toDateObj(dateStr, timeStr) {
-  if (!dateStr || !timeStr) return new Date(0); // fallback if missing
+function toDateObj(record = {}) {
+  if (typeof record.ts === "number") return new Date(record.ts);
+
+  const { date, time } = record;
+  if (!date || !time) return null;
 
   // Build a combined string the Date parser can read
-  const combined = `${dateStr} ${timeStr}`;
-  const d = new Date(combined);
+  const d = new Date(`${date} ${time}`);
+  return Number.isNaN(d.getTime()) ? null : d;
+}
 
-  // If parsing fails, return a very old date so it sorts last
-  return Number.isNaN(d.getTime()) ? new Date(0) : d;
+/**
+ * Format time as "1:07:04 PM" (browser locale / time zone)
+ */
+function formatTime(d) {
+  if (!d) return "—";
+  return d.toLocaleTimeString(undefined, {
+    hour: "numeric",
+    minute: "2-digit",
+    second: "2-digit"
+  });
 }
 
 /**
  * Format main dashboard date as:
  * "Saturday, February 21, 2026"
  */
-function formatLongDate(dateStr) {
-  if (!dateStr) return "—";
-
-  const d = new Date(`${dateStr}T00:00:00`);
-  if (Number.isNaN(d.getTime())) return dateStr;
+function formatLongDate(d) {
+  if (!d) return "—";
 
   return d.toLocaleDateString(undefined, {
     weekday: "long",
@@ -255,11 +265,8 @@ function formatLongDate(dateStr) {
  * Format history date as:
  * "02/21/26"
  */
-function formatShortDate(dateStr) {
-  if (!dateStr) return "—";
-
-  const d = new Date(`${dateStr}T00:00:00`);
-  if (Number.isNaN(d.getTime())) return dateStr;
+function formatShortDate(d) {
+  if (!d) return "—";
 
   return d.toLocaleDateString(undefined, {
     year: "2-digit",
@@ -399,14 +406,13 @@ onValue(
     if (elWindDir) elWindDir.textContent = data.windDirection ?? "—";
     if (elRms) elRms.textContent = data.rms ?? "—";
 
-     // Header date/time (right side of title)
-    const date = data.date ?? "";
-    const time = data.time ?? "";
+     // Header date/time (right side of title), formatted from the buoy's epoch-ms "ts"
+    const when = toDateObj(data);
     const headerTimeEl = document.getElementById("headerTime");
     const headerDateEl = document.getElementById("headerDate");
 
-    if (headerTimeEl) headerTimeEl.textContent = time;
-    if (headerDateEl) headerDateEl.textContent = formatLongDate(date);
+    if (headerTimeEl) headerTimeEl.textContent = when ? formatTime(when) : "Clock syncing…";
+    if (headerDateEl) headerDateEl.textContent = formatLongDate(when);
 
     // Buoy status (larger than label)
     const status = data.buoyStatus ?? "—";
@@ -476,14 +482,10 @@ onValue(
     }
 
     // Convert object -> array so we can sort and map
-    const rows = Object.entries(logsObj).map(([id, v]) => ({ id, ...v }));
+    const rows = Object.entries(logsObj).map(([id, v]) => ({ id, ...v, when: toDateObj(v) }));
 
-    // Sort newest first (for the history list display)
-    rows.sort((a, b) => {
-      const aDate = toDateObj(a.date, a.time);
-      const bDate = toDateObj(b.date, b.time);
-      return bDate - aDate;
-    });
+    // Sort newest first (for the history list display); undated rows sort last
+    rows.sort((a, b) => (b.when?.getTime() ?? 0) - (a.when?.getTime() ?? 0));
 
     // ---------- Build chart data from history rows ----------
     // History list is newest -> oldest, but chart should read left -> right (oldest -> newest)
@@ -491,7 +493,7 @@ onValue(
     const chartRows = [...rows].reverse().slice(-10);
 
     // X-axis labels (using time only to keep it short)
-    const chartLabels = chartRows.map((r) => r.time ?? "—");
+    const chartLabels = chartRows.map((r) => formatTime(r.when));
 
     // Y-axis values = wind speed (convert to numbers in case Firebase stores strings)
     const chartWindValues = chartRows.map((r) => Number(r.windMph) || 0);
@@ -502,7 +504,7 @@ onValue(
     // ---------- Build history list HTML ----------
     if (historyListEl) {
       historyListEl.innerHTML = rows.map((r) => {
-        const ts = (r.date && r.time) ? `${r.time} • ${r.date}` : (r.date || r.time || "—");
+        const ts = r.when ? `${formatTime(r.when)} • ${formatShortDate(r.when)}` : "—";
 
         return `
           <div class="history-row">
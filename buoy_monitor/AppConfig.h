@@ -23,8 +23,14 @@ static constexpr int PIN_LED_GREEN  = 6;
 
 // ---------------- Timing ----------------
 static constexpr uint32_t WEATHER_MS = 15UL * 60UL * 1000UL;
+static constexpr uint32_t WEATHER_CACHE_MAX_AGE_S = 6UL * 3600UL;   // older NVS snapshots are stale
 static constexpr uint32_t WIFI_RETRY_MS = 10000UL;
 
+// ---------------- Time (SNTP) ----------------
+static const char* TZ_INFO = "PST8PDT,M3.2.0/2,M11.1.0/2";   // Pacific Time with DST rules
+static const char* NTP_SERVER_1 = "pool.ntp.org";
+static const char* NTP_SERVER_2 = "time.nist.gov";
+
 // ---------------- BNO055 ----------------
 static constexpr uint8_t BNO_ADDR = 0x29;
 
@@ -38,6 +44,56 @@ static constexpr int WINDOW_MS = 2000;
 static constexpr int WINDOW_SAMPLES = (BNO_SAMPLE_RATE * WINDOW_MS) / 1000;
 static constexpr uint32_t SAMPLE_DT_MS = 1000UL / BNO_SAMPLE_RATE;
 static constexpr float BNO_ALPHA_LP = 0.25f;
+static constexpr uint32_t MOTION_RING_SAMPLES = 1024;  // ~20 s at 50 Hz (covers an HTTPS stall), keep a power of two
+
+// Sampling runs in its own task so blocking uploads in loop() do not stall it
+static constexpr uint32_t BNO_TASK_STACK = 4096;
+static constexpr UBaseType_t BNO_TASK_PRIORITY = 3;     // above loop() (1)
+static constexpr BaseType_t BNO_TASK_CORE = 1;          // same core as loop(), Wi-Fi stays on core 0
+
+// ---------------- Live stream (LAN) ----------------
+static constexpr bool LIVE_STREAM_ENABLED = true;
+static constexpr uint16_t LIVE_STREAM_PORT = 5055;          // raw TCP
+static constexpr uint16_t LIVE_STREAM_BATCH = 10;           // samples per frame (200 ms at 50 Hz)
+static constexpr uint16_t LIVE_STREAM_MAX_LAG_BATCHES = 4;  // drop frames beyond this backlog
+static constexpr uint32_t LIVE_STREAM_POLL_MS = 20;         // service task period (one sample)
+static constexpr uint32_t LIVE_STREAM_TASK_STACK = 4096;
+static constexpr UBaseType_t LIVE_STREAM_TASK_PRIORITY = 2; // below sampling, above loop()
+static constexpr BaseType_t LIVE_STREAM_TASK_CORE = 1;
+static constexpr bool LIVE_STREAM_MULTICAST = false;
+static const char* LIVE_STREAM_MCAST_GROUP = "239.10.0.55";
+static constexpr uint16_t LIVE_STREAM_MCAST_PORT = 5056;
+
+// ---------------- Waveform archive (SD) ----------------
+// Off by default: the SD card shares SPI pins with the LED outputs on some boards.
+static constexpr bool ARCHIVE_ENABLED = false;
+static constexpr uint8_t ARCHIVE_SD_CS_PIN = 10;
+static constexpr uint16_t ARCHIVE_BLOCK_SAMPLES = 256;                  // per compressed block
+static constexpr uint32_t ARCHIVE_FILE_MAX_BYTES = 16UL * 1024UL * 1024UL;
+static constexpr uint32_t ARCHIVE_POLL_MS = 100;               // archive task drain period
+static constexpr uint32_t ARCHIVE_TASK_STACK = 6144;           // SD/FAT calls need the headroom
+static constexpr UBaseType_t ARCHIVE_TASK_PRIORITY = 2;        // below sampling, above loop()
+static constexpr BaseType_t ARCHIVE_TASK_CORE = 1;
+
+// ---------------- Event capture ----------------
+static constexpr uint16_t EVENT_PRE_SAMPLES = 150;       // 3 s before the trigger
+static constexpr uint16_t EVENT_POST_SAMPLES = 250;      // 5 s after the trigger
+static constexpr float EVENT_ABS_THRESHOLD = 12.0f;      // |aVert| m/s^2 (impact / slam)
+static constexpr float EVENT_JERK_THRESHOLD = 400.0f;    // m/s^3 (collision)
+static constexpr float EVENT_STA_S = 0.5f;
+static constexpr float EVENT_LTA_S = 30.0f;
+static constexpr float EVENT_STA_LTA_RATIO = 6.0f;       // sudden energy jump (rogue wave)
+static constexpr uint32_t EVENT_HOLDOFF_MS = 30000UL;
+static constexpr uint32_t EVENT_RETRY_MS = 30000UL;      // upload retry while offline
+static_assert(EVENT_PRE_SAMPLES < MOTION_RING_SAMPLES, "pre-trigger window must fit the ring");
+
+// ---------------- Wave statistics ----------------
+static constexpr uint32_t STATS_SHORT_MS = 10UL * 60UL * 1000UL;   // 10 min horizon
+static constexpr uint32_t STATS_LONG_MS  = 60UL * 60UL * 1000UL;   // 1 h horizon
+static constexpr float WAVE_MIN_PERIOD_S = 1.0f;
+static constexpr float WAVE_MAX_PERIOD_S = 25.0f;
+static constexpr float WAVE_HYSTERESIS = 0.05f;                    // m/s^2 below zero to re-arm
+static constexpr float WAVE_MAX_RANGE = 9.81f;                     // aLP range of real swell stays within +-g/2
 
 // ---------------- Wave thresholds ----------------
 static constexpr float RMS_BAD_MAX = 0.8f;
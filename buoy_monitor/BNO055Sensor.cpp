@@ -3,7 +3,7 @@
 #include <math.h>
 
 BNO055Sensor::BNO055Sensor(uint8_t bnoAddr)
-: _bno(55, bnoAddr) {}
+: _bno(55, bnoAddr), _ring(_ringStorage, MOTION_RING_SAMPLES) {}
 
 bool BNO055Sensor::begin() {
   Wire.begin();
@@ -15,16 +15,30 @@ bool BNO055Sensor::begin() {
 
   _bno.setExtCrystalUse(false);
   _ready = true;
-  _lastSampleMs = millis();
+
+  if (_task == nullptr &&
+      xTaskCreatePinnedToCore(taskEntry, "bno_sampler", BNO_TASK_STACK, this,
+                              BNO_TASK_PRIORITY, &_task, BNO_TASK_CORE) != pdPASS) {
+    _task = nullptr;
+    _ready = false;
+    return false;
+  }
   return true;
 }
 
-void BNO055Sensor::update() {
-  if (!_ready) return;
+// Sampling task: fixed-rate ticks, so samples stay on the SAMPLE_DT_MS grid
+// no matter how long loop() is blocked on Wi-Fi/HTTPS.
+void BNO055Sensor::taskEntry(void* arg) {
+  BNO055Sensor* self = static_cast<BNO055Sensor*>(arg);
+  TickType_t wake = xTaskGetTickCount();
+  for (;;) {
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(SAMPLE_DT_MS));
+    self->sampleOnce();
+  }
+}
 
+void BNO055Sensor::sampleOnce() {
   unsigned long now = millis();
-  if (now - _lastSampleMs < SAMPLE_DT_MS) return;
-  _lastSampleMs = now;
 
   // Read accel + gravity
   imu::Vector<3> accel = _bno.getVector(Adafruit_BNO055::VECTOR_ACCELEROMETER);
@@ -44,6 +58,16 @@ void BNO055Sensor::update() {
   // Low-pass filter
   _aLP = (1.0f - BNO_ALPHA_LP) * _aLP + BNO_ALPHA_LP * aVert;
 
+  // Publish sample to the acquisition ring
+  MotionSample s;
+  s.tMs = now;
+  s.ax = accel.x();
+  s.ay = accel.y();
+  s.az = accel.z();
+  s.aVert = aVert;
+  s.aLP = _aLP;
+  _ring.push(s);
+
   // RMS accumulators
   _sumSquares += _aLP * _aLP;
   _sampleCount++;
@@ -63,11 +87,16 @@ void BNO055Sensor::update() {
 
   // Window complete
   if (_sampleCount >= WINDOW_SAMPLES) {
-    _latest.rms = sqrt(_sumSquares / (float)_sampleCount);
-    _latest.avgPeriod = (_periodCount > 0) ? (_periodSum / _periodCount) : 0.0f;
-    _latest.crossings = _periodCount;
-    _latest.valid = true;
+    BNO055SensorReading r;
+    r.rms = sqrt(_sumSquares / (float)_sampleCount);
+    r.avgPeriod = (_periodCount > 0) ? (_periodSum / _periodCount) : 0.0f;
+    r.crossings = _periodCount;
+    r.valid = true;
+
+    portENTER_CRITICAL(&_mux);
+    _latest = r;
     _hasResult = true;
+    portEXIT_CRITICAL(&_mux);
 
     // Reset window
     _sumSquares = 0.0f;
@@ -78,10 +107,16 @@ void BNO055Sensor::update() {
 }
 
 bool BNO055Sensor::hasWindowResult() const {
-  return _hasResult;
+  portENTER_CRITICAL(&_mux);
+  bool ready = _hasResult;
+  portEXIT_CRITICAL(&_mux);
+  return ready;
 }
 
 BNO055SensorReading BNO055Sensor::takeWindowResult() {
+  portENTER_CRITICAL(&_mux);
   _hasResult = false;
-  return _latest;
+  BNO055SensorReading r = _latest;
+  portEXIT_CRITICAL(&_mux);
+  return r;
 }
@@ -3,6 +3,8 @@
 #include <Wire.h>
 #include <Adafruit_Sensor.h>
 #include <Adafruit_BNO055.h>
+#include "AppConfig.h"
+#include "MotionRing.h"
 
 struct BNO055SensorReading {
   float rms = 0.0f;
@@ -15,14 +17,19 @@ class BNO055Sensor {
 public:
   explicit BNO055Sensor (uint8_t bnoAddr = 0x29);
 
-  bool begin();
-  void update();                       // call every loop iteration
+  bool begin();                        // also starts the sampling task
   bool hasWindowResult() const;        // true when window is ready
   BNO055SensorReading takeWindowResult();    // consume latest result
 
+  const MotionRing& samples() const { return _ring; }  // every raw/filtered sample
+
 private:
+  static void taskEntry(void* arg);
+  void sampleOnce();
+
   Adafruit_BNO055 _bno;
   bool _ready = false;
+  TaskHandle_t _task = nullptr;
 
   /*// Sampling/window config
   static constexpr int sampleRate = 50;
@@ -41,10 +48,14 @@ private:
   float _periodSum = 0.0f;
   int _periodCount = 0;
 
-  // Timing
-  unsigned long _lastSampleMs = 0;
   //static constexpr uint32_t sampleDtMs = 1000UL / sampleRate;
 
+  // Window result handed from the sampling task to loop()
+  mutable portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
   bool _hasResult = false;
   BNO055SensorReading _latest{};
+
+  // Acquisition ring (full-rate samples for streaming consumers)
+  MotionSample _ringStorage[MOTION_RING_SAMPLES];
+  MotionRing _ring;
 };
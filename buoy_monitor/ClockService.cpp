@@ -0,0 +1,79 @@
+#include <time.h>
+#include <esp_sntp.h>
+#include "ClockService.h"
+
+ClockService* ClockService::_instance = nullptr;
+
+ClockService::ClockService(const char* tz, const char* server1, const char* server2)
+: _tz(tz), _server1(server1), _server2(server2) {}
+
+void ClockService::begin() {
+  _instance = this;
+  setenv("TZ", _tz, 1);
+  tzset();
+  sntp_set_time_sync_notification_cb(&ClockService::onTimeSync);
+}
+
+void ClockService::startSync() {
+  // configTzTime (re)starts the SNTP client and returns without waiting
+  configTzTime(_tz, _server1, _server2);
+}
+
+/*
+  Runs in the SNTP/lwIP task right after the system clock was set.
+*/
+void ClockService::onTimeSync(struct timeval* tv) {
+  ClockService* self = _instance;
+  if (!self) return;
+
+  struct timeval now;
+  if (!tv) {
+    gettimeofday(&now, nullptr);
+    tv = &now;
+  }
+
+  uint32_t ms = millis();
+  int64_t epochMs = (int64_t)tv->tv_sec * 1000 + tv->tv_usec / 1000;
+
+  portENTER_CRITICAL(&self->_mux);
+  self->_syncMillis = ms;
+  self->_syncEpochMs = epochMs;
+  self->_syncCount = self->_syncCount + 1;
+  portEXIT_CRITICAL(&self->_mux);
+}
+
+bool ClockService::isSynced() const {
+  return _syncCount > 0;
+}
+
+bool ClockService::takeSyncEvent() {
+  uint32_t c = _syncCount;
+  if (c == _seenSyncCount) return false;
+  _seenSyncCount = c;
+  return true;
+}
+
+int64_t ClockService::epochMsAt(uint32_t tMs) const {
+  portENTER_CRITICAL(&_mux);
+  uint32_t syncMillis = _syncMillis;
+  int64_t syncEpochMs = _syncEpochMs;
+  uint32_t count = _syncCount;
+  portEXIT_CRITICAL(&_mux);
+
+  if (count == 0) return 0;
+
+  // Signed distance handles millis() wrap and stamps taken before the sync
+  return syncEpochMs + (int32_t)(tMs - syncMillis);
+}
+
+void ClockService::formatLocal(char* out, size_t outSize) const {
+  if (!isSynced()) {
+    snprintf(out, outSize, "UNSYNCED");
+    return;
+  }
+
+  time_t nowTs = (time_t)(nowEpochMs() / 1000);
+  struct tm ti;
+  localtime_r(&nowTs, &ti);
+  strftime(out, outSize, "%Y-%m-%d %H:%M:%S %Z", &ti);
+}
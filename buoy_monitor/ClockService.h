@@ -0,0 +1,42 @@
+#pragma once
+#include <Arduino.h>
+#include <sys/time.h>
+
+/**
+ * @brief Non-blocking SNTP clock with a cached millis() -> UTC mapping.
+ *
+ * startSync() only (re)starts SNTP; the SNTP task calls back when time arrives
+ * and the service stores one (millis, epoch ms) anchor. Any millis() timestamp,
+ * including ones taken before the sync, converts to epoch ms with one subtraction.
+ * SNTP keeps re-syncing in the background and each callback refreshes the anchor.
+ */
+class ClockService {
+public:
+  ClockService(const char* tz, const char* server1, const char* server2);
+
+  void begin();                           // set TZ + sync callback (no network needed)
+  void startSync();                       // kick SNTP; returns immediately
+
+  bool isSynced() const;
+  uint32_t syncCount() const { return _syncCount; }
+  bool takeSyncEvent();                   // true once after each new sync
+
+  int64_t epochMsAt(uint32_t tMs) const;  // UTC ms for a millis() stamp, 0 if unsynced
+  int64_t nowEpochMs() const { return epochMsAt(millis()); }
+
+  void formatLocal(char* out, size_t outSize) const;  // serial/debug only
+
+private:
+  const char* _tz;
+  const char* _server1;
+  const char* _server2;
+
+  mutable portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+  uint32_t _syncMillis = 0;
+  int64_t _syncEpochMs = 0;
+  volatile uint32_t _syncCount = 0;
+  uint32_t _seenSyncCount = 0;
+
+  static ClockService* _instance;
+  static void onTimeSync(struct timeval* tv);
+};
@@ -0,0 +1,155 @@
+#include "EventDetector.h"
+#include "WaveformCodec.h"
+#include <math.h>
+
+EventDetector::EventDetector() {
+  begin(EventDetectorConfig());
+}
+
+void EventDetector::begin(const EventDetectorConfig& cfg) {
+  _cfg = cfg;
+  _state = State::ARMED;
+  _cursorValid = false;
+
+  if (_cfg.sampleRateHz == 0) _cfg.sampleRateHz = 50;
+  _gapMs = motionGapMs(_cfg.sampleRateHz);
+
+  // Never capture more than the frozen buffer holds
+  if (_cfg.preSamples >= CapturedEvent::MAX_SAMPLES) _cfg.preSamples = CapturedEvent::MAX_SAMPLES / 2;
+  if ((uint32_t)_cfg.preSamples + 1 + _cfg.postSamples > CapturedEvent::MAX_SAMPLES) {
+    _cfg.postSamples = CapturedEvent::MAX_SAMPLES - _cfg.preSamples - 1;
+  }
+
+  // One-pole averages: alpha = 1 / (seconds * rate)
+  _staAlpha = 1.0f / fmaxf(1.0f, _cfg.staSeconds * _cfg.sampleRateHz);
+  _ltaAlpha = 1.0f / fmaxf(1.0f, _cfg.ltaSeconds * _cfg.sampleRateHz);
+  rewarm();
+}
+
+// Forget the signal history: no jerk across the gap, STA/LTA starts over
+void EventDetector::rewarm() {
+  _havePrev = false;
+  _sta = 0.0f;
+  _lta = 0.0f;
+  _warmupLeft = (uint32_t)(_cfg.ltaSeconds * _cfg.sampleRateHz);
+}
+
+// Sampling time missing in a step between two consecutive samples
+uint32_t EventDetector::gapOf(uint32_t stepMs) const {
+  return (stepMs > _gapMs) ? stepMs - 1000UL / _cfg.sampleRateHz : 0;
+}
+
+void EventDetector::poll(const MotionRing& ring) {
+  if (!_cursorValid) {
+    _nextSeq = ring.headSeq();
+    _cursorValid = true;
+  }
+
+  // Fell behind the ring: restart from the oldest sample we still have.
+  // The jump in tMs is then handled like any other gap below.
+  if (ring.overrun(_nextSeq)) _nextSeq = ring.oldestSeq();
+
+  MotionSample s;
+  while (ring.read(_nextSeq, s)) {
+    uint32_t seq = _nextSeq++;
+
+    uint32_t gap = _havePrev ? gapOf(s.tMs - _prevTMs) : 0;
+    if (gap > 0) rewarm();
+
+    float jerk = 0.0f;
+    float ratio = 0.0f;
+    EventTrigger why = check(s, jerk, ratio);
+
+    if (_state == State::CAPTURING) {
+      _event.gapMs += gap;
+      append(s.aVert);
+      if (_event.count >= _event.preSamples + 1 + _cfg.postSamples) {
+        _state = State::READY;
+        _captured++;
+      }
+      continue;
+    }
+
+    if (why == EventTrigger::NONE) continue;
+    if (_haveLastEvent && (s.tMs - _lastEventMs) < _cfg.holdoffMs) continue;
+
+    if (_state == State::READY) {
+      _missed++;
+      continue;
+    }
+
+    startCapture(ring, seq, why, jerk, ratio);
+    _lastEventMs = s.tMs;
+    _haveLastEvent = true;
+  }
+}
+
+/*
+  Per-sample detector update. Returns the strongest trigger that fired.
+*/
+EventTrigger EventDetector::check(const MotionSample& s, float& jerk, float& ratio) {
+  float a = s.aVert;
+  float e = a * a;
+
+  jerk = _havePrev ? fabsf(a - _prevAVert) * _cfg.sampleRateHz : 0.0f;
+  _prevAVert = a;
+  _prevTMs = s.tMs;
+  _havePrev = true;
+
+  _sta += _staAlpha * (e - _sta);
+  _lta += _ltaAlpha * (e - _lta);
+  ratio = _sta / (_lta + _cfg.ltaFloor);
+
+  if (_warmupLeft > 0) {
+    _warmupLeft--;
+    ratio = 0.0f;   // LTA not meaningful yet
+  }
+
+  if (fabsf(a) >= _cfg.absThreshold) return EventTrigger::THRESHOLD;
+  if (jerk >= _cfg.jerkThreshold) return EventTrigger::JERK;
+  if (ratio >= _cfg.staLtaRatio) return EventTrigger::STA_LTA;
+  return EventTrigger::NONE;
+}
+
+void EventDetector::startCapture(const MotionRing& ring, uint32_t triggerSeq, EventTrigger why,
+                                 float jerk, float ratio) {
+  _event.trigger = why;
+  _event.sampleRateHz = _cfg.sampleRateHz;
+  _event.jerkAtTrigger = jerk;
+  _event.staLtaAtTrigger = ratio;
+  _event.peakAbs = 0.0f;
+  _event.gapMs = 0;
+  _event.count = 0;
+
+  // Pre-trigger part straight from the acquisition ring (may be short right after boot)
+  uint32_t pre = _cfg.preSamples;
+  uint32_t held = triggerSeq - ring.oldestSeq();
+  if (pre > held) pre = held;
+
+  MotionSample s;
+  uint32_t prevTMs = 0;
+  for (uint32_t seq = triggerSeq - pre; seq != triggerSeq + 1; seq++) {
+    if (!ring.read(seq, s)) continue;
+    if (_event.count == 0) _event.startMs = s.tMs;
+    else _event.gapMs += gapOf(s.tMs - prevTMs);
+    prevTMs = s.tMs;
+    if (seq == triggerSeq) {
+      _event.triggerMs = s.tMs;
+      _event.preSamples = _event.count;
+    }
+    append(s.aVert);
+  }
+
+  _state = State::CAPTURING;
+}
+
+void EventDetector::append(float aVert) {
+  if (_event.count >= CapturedEvent::MAX_SAMPLES) return;
+  _event.aVert[_event.count++] = waveQuantize(aVert);
+  float m = fabsf(aVert);
+  if (m > _event.peakAbs) _event.peakAbs = m;
+}
+
+void EventDetector::release() {
+  if (_state == State::READY) _state = State::ARMED;
+}
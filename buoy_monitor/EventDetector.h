@@ -0,0 +1,111 @@
+#pragma once
+#include <stdint.h>
+#include "MotionRing.h"
+
+/**
+ * @brief What fired an event capture.
+ */
+enum class EventTrigger : uint8_t { NONE, THRESHOLD, JERK, STA_LTA };
+
+inline const char* toString(EventTrigger t) {
+  switch (t) {
+    case EventTrigger::THRESHOLD: return "THRESHOLD";
+    case EventTrigger::JERK:      return "JERK";
+    case EventTrigger::STA_LTA:   return "STA_LTA";
+    default: return "NONE";
+  }
+}
+
+/**
+ * @brief Detector thresholds (see AppConfig.h for the values in use).
+ */
+struct EventDetectorConfig {
+  uint16_t sampleRateHz = 50;
+  uint16_t preSamples = 150;        // kept from before the trigger
+  uint16_t postSamples = 250;       // captured after the trigger sample
+  float absThreshold = 12.0f;       // |aVert| (m/s^2)
+  float jerkThreshold = 400.0f;     // |d aVert / dt| (m/s^3)
+  float staSeconds = 0.5f;          // short-term energy average
+  float ltaSeconds = 30.0f;         // long-term energy average
+  float staLtaRatio = 6.0f;
+  float ltaFloor = 0.05f;           // (m/s^2)^2, keeps calm water from triggering
+  uint32_t holdoffMs = 30000;       // quiet time after a capture
+};
+
+/**
+ * @brief One frozen event window: vertical acceleration around the trigger.
+ */
+struct CapturedEvent {
+  static constexpr uint16_t MAX_SAMPLES = 512;
+
+  EventTrigger trigger = EventTrigger::NONE;
+  uint32_t triggerMs = 0;        // millis() of the trigger sample
+  uint32_t startMs = 0;          // millis() of aVert[0]
+  uint16_t sampleRateHz = 0;
+  uint16_t preSamples = 0;       // index of the trigger sample in aVert
+  uint16_t count = 0;
+  float peakAbs = 0.0f;          // max |aVert| in the window (m/s^2)
+  float jerkAtTrigger = 0.0f;    // (m/s^3)
+  float staLtaAtTrigger = 0.0f;
+  uint32_t gapMs = 0;            // sampling time missing inside the window (0 = contiguous)
+  int16_t aVert[MAX_SAMPLES];    // counts of 0.01 m/s^2
+};
+
+/**
+ * @brief Triggered capture of short motion events (impacts, capsizes, extreme waves).
+ *
+ * Runs per sample on the acquisition ring: absolute threshold, jerk and STA/LTA
+ * on vertical acceleration. The ring is the pre-trigger buffer; on trigger the
+ * preceding preSamples are copied and the next postSamples appended, then the
+ * window is frozen until the caller has uploaded it and calls release().
+ * A step longer than motionGapMs() (samples missing after a ring overrun) is a gap: jerk
+ * restarts, STA/LTA warms up again and a window spanning it records gapMs.
+ * O(1) per sample, no allocation. Plain C++ (no Arduino headers).
+ */
+class EventDetector {
+public:
+  EventDetector();
+
+  void begin(const EventDetectorConfig& cfg);
+  void poll(const MotionRing& ring);   // call every loop iteration
+
+  bool hasEvent() const { return _state == State::READY; }
+  const CapturedEvent& event() const { return _event; }
+  void release();                      // after the event was uploaded
+
+  uint32_t eventsCaptured() const { return _captured; }
+  uint32_t eventsMissed() const { return _missed; }   // triggers while a window was pending
+
+private:
+  enum class State : uint8_t { ARMED, CAPTURING, READY };
+
+  EventDetectorConfig _cfg;
+  State _state = State::ARMED;
+
+  uint32_t _nextSeq = 0;
+  bool _cursorValid = false;
+
+  // Detector state
+  float _prevAVert = 0.0f;
+  uint32_t _prevTMs = 0;
+  bool _havePrev = false;
+  uint32_t _gapMs = 0;
+  float _sta = 0.0f;
+  float _lta = 0.0f;
+  float _staAlpha = 0.0f;
+  float _ltaAlpha = 0.0f;
+  uint32_t _warmupLeft = 0;
+  uint32_t _lastEventMs = 0;
+  bool _haveLastEvent = false;
+
+  CapturedEvent _event;
+  uint32_t _captured = 0;
+  uint32_t _missed = 0;
+
+  EventTrigger check(const MotionSample& s, float& jerk, float& ratio);
+  void rewarm();
+  uint32_t gapOf(uint32_t stepMs) const;
+  void startCapture(const MotionRing& ring, uint32_t triggerSeq, EventTrigger why,
+                    float jerk, float ratio);
+  void append(float aVert);
+};
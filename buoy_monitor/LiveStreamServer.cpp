@@ -0,0 +1,262 @@
+#include "LiveStreamServer.h"
+
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static const uint8_t FRAME_MAGIC[4] = {'B', 'Y', 'L', 'S'};
+static constexpr uint16_t FRAME_VERSION = 1;
+
+// ---------- Small helpers ----------
+static void setNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  if (flags >= 0) fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static bool wouldBlock(int err) {
+  return err == EAGAIN || err == EWOULDBLOCK || err == EINTR;
+}
+
+static uint8_t* put16(uint8_t* p, uint16_t v) { memcpy(p, &v, 2); return p + 2; }
+static uint8_t* put32(uint8_t* p, uint32_t v) { memcpy(p, &v, 4); return p + 4; }
+static uint8_t* putF(uint8_t* p, float v)     { memcpy(p, &v, 4); return p + 4; }
+
+// ---------- Constructor ----------
+LiveStreamServer::LiveStreamServer(uint16_t tcpPort, uint16_t batchSamples, uint16_t maxLagBatches)
+: _port(tcpPort) {
+  if (batchSamples < 1) batchSamples = 1;
+  if (batchSamples > MAX_BATCH) batchSamples = MAX_BATCH;
+  if (maxLagBatches < 1) maxLagBatches = 1;
+  _batch = batchSamples;
+  _maxLagSamples = (uint32_t)_batch * maxLagBatches;
+  memset(&_mcastAddr, 0, sizeof(_mcastAddr));
+}
+
+LiveStreamServer::~LiveStreamServer() {
+  stop();
+}
+
+bool LiveStreamServer::begin() {
+  if (_listenFd >= 0) return true;
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return false;
+
+  int yes = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(_port);
+
+  if (bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, MAX_CLIENTS) < 0) {
+    close(fd);
+    return false;
+  }
+
+  setNonBlocking(fd);
+  _listenFd = fd;
+  return true;
+}
+
+bool LiveStreamServer::enableMulticast(const char* groupIp, uint16_t port) {
+  if (_udpFd >= 0) return true;
+
+  memset(&_mcastAddr, 0, sizeof(_mcastAddr));
+  _mcastAddr.sin_family = AF_INET;
+  _mcastAddr.sin_port = htons(port);
+  if (inet_pton(AF_INET, groupIp, &_mcastAddr.sin_addr) != 1) return false;
+
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) return false;
+
+  uint8_t ttl = 1;  // stay on the local network
+  setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+  setNonBlocking(fd);
+
+  _udpFd = fd;
+  _multicast.fd = fd;
+  _multicast.frameLen = 0;
+  _multicast.frameOff = 0;
+  _multicast.dropped = 0;
+  _multicastStarted = false;
+  return true;
+}
+
+void LiveStreamServer::stop() {
+  for (int i = 0; i < MAX_CLIENTS; i++) closeClient(_clients[i]);
+  if (_listenFd >= 0) { close(_listenFd); _listenFd = -1; }
+  if (_udpFd >= 0) { close(_udpFd); _udpFd = -1; }
+  _multicast.fd = -1;
+}
+
+int LiveStreamServer::clientCount() const {
+  int n = 0;
+  for (int i = 0; i < MAX_CLIENTS; i++) {
+    if (_clients[i].fd >= 0) n++;
+  }
+  return n;
+}
+
+/*
+  poll: accept new readers, then push whole batches to each reader.
+  Everything is non-blocking, so a slow or dead client costs at most one failed send.
+*/
+void LiveStreamServer::poll(const MotionRing& ring) {
+  if (_listenFd >= 0) acceptClients(ring.headSeq());
+
+  for (int i = 0; i < MAX_CLIENTS; i++) {
+    if (_clients[i].fd >= 0) serviceClient(_clients[i], ring);
+  }
+
+  if (_udpFd >= 0) serviceMulticast(ring);
+}
+
+void LiveStreamServer::acceptClients(uint32_t headSeq) {
+  for (;;) {
+    int fd = accept(_listenFd, nullptr, nullptr);
+    if (fd < 0) return;  // EAGAIN: no pending connection
+
+    Reader* slot = nullptr;
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+      if (_clients[i].fd < 0) { slot = &_clients[i]; break; }
+    }
+    if (!slot) {
+      close(fd);  // full
+      continue;
+    }
+
+    setNonBlocking(fd);
+    int yes = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+    slot->fd = fd;
+    slot->nextSeq = headSeq;  // start live, no backlog
+    slot->dropped = 0;
+    slot->frameLen = 0;
+    slot->frameOff = 0;
+  }
+}
+
+void LiveStreamServer::serviceClient(Reader& c, const MotionRing& ring) {
+  // Detect hang-up; anything the client sends is ignored
+  uint8_t sink[32];
+  ssize_t n = recv(c.fd, sink, sizeof(sink), MSG_DONTWAIT);
+  if (n == 0 || (n < 0 && !wouldBlock(errno))) {
+    closeClient(c);
+    return;
+  }
+
+  // Finish a partially written frame before starting a new one (keeps framing intact)
+  if (!flushPending(c)) { closeClient(c); return; }
+  if (c.frameOff < c.frameLen) return;
+
+  skipLag(c, ring);
+
+  while (ring.availableFrom(c.nextSeq) >= _batch) {
+    buildFrame(c, ring);
+    if (!flushPending(c)) { closeClient(c); return; }
+    if (c.frameOff < c.frameLen) return;  // socket full; retry next poll
+  }
+}
+
+void LiveStreamServer::serviceMulticast(const MotionRing& ring) {
+  Reader& m = _multicast;
+
+  // Like a new TCP reader: start at the live edge, not at the start of the ring
+  if (!_multicastStarted) {
+    m.nextSeq = ring.headSeq();
+    _multicastStarted = true;
+  }
+  skipLag(m, ring);
+
+  while (ring.availableFrom(m.nextSeq) >= _batch) {
+    size_t len = buildFrame(m, ring);
+    ssize_t n = sendto(m.fd, m.frame, len, MSG_DONTWAIT,
+                       (const sockaddr*)&_mcastAddr, sizeof(_mcastAddr));
+    m.frameLen = 0;
+    m.frameOff = 0;
+    if (n < 0) {
+      // Datagram lost either way; count it and try again next poll
+      m.dropped += _batch;
+      _samplesDropped += _batch;
+      return;
+    }
+    _framesSent++;
+  }
+}
+
+// Drop the oldest samples of a reader that fell too far behind (or got overwritten)
+void LiveStreamServer::skipLag(Reader& r, const MotionRing& ring) {
+  uint32_t head = ring.headSeq();
+  uint32_t avail = ring.availableFrom(r.nextSeq);
+  uint32_t limit = _maxLagSamples;
+  if (limit > ring.capacity() - 1) limit = ring.capacity() - 1;
+
+  if (avail > limit) {
+    uint32_t newSeq = head - _batch;  // keep only the newest batch
+    uint32_t skipped = newSeq - r.nextSeq;
+    r.nextSeq = newSeq;
+    r.dropped += skipped;
+    _samplesDropped += skipped;
+  }
+}
+
+size_t LiveStreamServer::buildFrame(Reader& r, const MotionRing& ring) {
+  uint8_t* p = r.frame;
+  memcpy(p, FRAME_MAGIC, 4);
+  p += 4;
+  p = put16(p, FRAME_VERSION);
+  p = put16(p, _batch);
+  p = put32(p, r.nextSeq);
+  p = put32(p, r.dropped);
+
+  MotionSample s;
+  for (uint16_t i = 0; i < _batch; i++) {
+    if (!ring.read(r.nextSeq + i, s)) s = MotionSample();  // lapped by the writer mid-frame
+    p = put32(p, s.tMs);
+    p = putF(p, s.ax);
+    p = putF(p, s.ay);
+    p = putF(p, s.az);
+    p = putF(p, s.aVert);
+    p = putF(p, s.aLP);
+  }
+  r.nextSeq += _batch;
+
+  r.frameLen = (size_t)(p - r.frame);
+  r.frameOff = 0;
+  return r.frameLen;
+}
+
+bool LiveStreamServer::flushPending(Reader& c) {
+  while (c.frameOff < c.frameLen) {
+    ssize_t n = send(c.fd, c.frame + c.frameOff, c.frameLen - c.frameOff,
+                     MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (n < 0) return wouldBlock(errno);
+    c.frameOff += (size_t)n;
+  }
+  if (c.frameLen > 0) {
+    _framesSent++;
+    c.frameLen = 0;
+    c.frameOff = 0;
+  }
+  return true;
+}
+
+void LiveStreamServer::closeClient(Reader& c) {
+  if (c.fd >= 0) close(c.fd);
+  c.fd = -1;
+  c.frameLen = 0;
+  c.frameOff = 0;
+}
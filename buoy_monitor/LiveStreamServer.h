@@ -0,0 +1,79 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <netinet/in.h>
+#include "MotionRing.h"
+
+/**
+ * @brief Streams full-rate motion samples from the acquisition ring to LAN clients.
+ *
+ * Transport: raw TCP (any number of readers up to MAX_CLIENTS) and optional UDP multicast.
+ * Samples are sent in batches; each frame is little-endian:
+ *
+ *   header (16 bytes): "BYLS" | u16 version | u16 count | u32 firstSeq | u32 dropped
+ *   count x sample (24 bytes): u32 tMs | f32 ax | f32 ay | f32 az | f32 aVert | f32 aLP
+ *
+ * "dropped" is the running number of samples skipped for that reader, so clients can
+ * tell gaps from the seq numbers and from the counter.
+ *
+ * Backpressure: sockets are non-blocking. A client that cannot keep up is skipped
+ * ahead (frames dropped) once it falls more than maxLagBatches behind; sampling is
+ * never delayed. Frame buffers are fixed, nothing is allocated per sample.
+ *
+ * Uses BSD sockets (lwIP on ESP32) so the same code runs on the host over loopback.
+ */
+class LiveStreamServer {
+public:
+  static constexpr int MAX_CLIENTS = 4;
+  static constexpr uint16_t MAX_BATCH = 25;
+  static constexpr size_t HEADER_BYTES = 16;
+  static constexpr size_t SAMPLE_BYTES = 24;
+  static constexpr size_t MAX_FRAME_BYTES = HEADER_BYTES + MAX_BATCH * SAMPLE_BYTES;
+
+  LiveStreamServer(uint16_t tcpPort, uint16_t batchSamples, uint16_t maxLagBatches = 4);
+  ~LiveStreamServer();
+
+  bool begin();                                            // open TCP listener
+  bool enableMulticast(const char* groupIp, uint16_t port); // optional UDP multicast output
+  void stop();
+
+  void poll(const MotionRing& ring);                       // call every sample period, from one task
+
+  int clientCount() const;
+  uint32_t framesSent() const { return _framesSent; }
+  uint32_t samplesDropped() const { return _samplesDropped; }
+
+private:
+  struct Reader {
+    int fd = -1;
+    uint32_t nextSeq = 0;
+    uint32_t dropped = 0;
+    uint8_t frame[MAX_FRAME_BYTES];
+    size_t frameLen = 0;   // bytes in frame
+    size_t frameOff = 0;   // bytes already sent (partial TCP write)
+  };
+
+  uint16_t _port;
+  uint16_t _batch;
+  uint32_t _maxLagSamples;
+
+  int _listenFd = -1;
+  Reader _clients[MAX_CLIENTS];
+
+  int _udpFd = -1;
+  Reader _multicast;
+  bool _multicastStarted = false;   // nextSeq set to the ring head on the first poll
+  sockaddr_in _mcastAddr;  // multicast group destination
+
+  uint32_t _framesSent = 0;
+  uint32_t _samplesDropped = 0;
+
+  void acceptClients(uint32_t headSeq);
+  void serviceClient(Reader& c, const MotionRing& ring);
+  void serviceMulticast(const MotionRing& ring);
+
+  void skipLag(Reader& r, const MotionRing& ring);
+  size_t buildFrame(Reader& r, const MotionRing& ring);
+  bool flushPending(Reader& c);    // false if the client should be closed
+  void closeClient(Reader& c);
+};
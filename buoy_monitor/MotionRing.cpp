@@ -0,0 +1,41 @@
+#include "MotionRing.h"
+
+MotionRing::MotionRing(MotionSample* storage, uint32_t capacity)
+: _storage(storage), _capacity(capacity) {}
+
+void MotionRing::push(const MotionSample& s) {
+  uint32_t head = _head.load(std::memory_order_relaxed);
+  _storage[head % _capacity] = s;
+
+  uint32_t count = _count.load(std::memory_order_relaxed);
+  if (count < _capacity) _count.store(count + 1, std::memory_order_relaxed);
+  _head.store(head + 1, std::memory_order_release);
+
+  // Next push starts overwriting a slot: readers must see the new head first
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+uint32_t MotionRing::readable() const {
+  uint32_t count = _count.load(std::memory_order_relaxed);
+  return (count < _capacity) ? count : _capacity - 1;
+}
+
+uint32_t MotionRing::oldestSeq() const {
+  return headSeq() - readable();
+}
+
+uint32_t MotionRing::availableFrom(uint32_t seq) const {
+  // Wrap-safe: seq is "behind" head if the signed distance is positive
+  int32_t ahead = (int32_t)(headSeq() - seq);
+  return (ahead > 0) ? (uint32_t)ahead : 0;
+}
+
+bool MotionRing::read(uint32_t seq, MotionSample& out) const {
+  uint32_t behind = headSeq() - seq;      // 1 = newest sample
+  if (behind == 0 || behind > readable()) return false;
+  out = _storage[seq % _capacity];
+
+  // The writer may have lapped us while copying: only trust the copy if not
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return (headSeq() - seq) < _capacity;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * @brief One motion sample as produced by the BNO055Sensor sampling task.
+ */
+struct MotionSample {
+  uint32_t tMs = 0;     // millis() when the sample was taken
+  float ax = 0.0f;      // Raw accelerometer X (m/s^2)
+  float ay = 0.0f;      // Raw accelerometer Y (m/s^2)
+  float az = 0.0f;      // Raw accelerometer Z (m/s^2)
+  float aVert = 0.0f;   // Vertical acceleration with gravity removed (m/s^2)
+  float aLP = 0.0f;     // Low-pass filtered aVert (m/s^2)
+};
+
+/**
+ * @brief Longest step between consecutive samples that still counts as contiguous.
+ *
+ * 1.5 sample periods. Sampling is phase-locked in its own task, so a longer step
+ * means samples are missing: a reader was lapped and skipped ahead (ring overrun),
+ * or the sampling task was starved. Consumers treat such a step as a gap.
+ */
+inline uint32_t motionGapMs(uint16_t sampleRateHz) {
+  return (sampleRateHz > 0) ? 3000UL / (2UL * sampleRateHz) : 100UL;
+}
+
+/**
+ * @brief Fixed-capacity ring of recent motion samples (acquisition buffer).
+ *
+ * Every sample gets a running sequence number. Consumers (live stream, archive, ...)
+ * keep their own cursor and read at their own pace; the writer never waits on them.
+ * Storage is owned by the caller so no allocation happens here.
+ *
+ * One writer (the sampling task) and readers on another task are fine without locks:
+ * push() publishes the head only after the slot is written, and read() re-checks the
+ * head after copying so a slot the writer was busy overwriting is reported as lost.
+ * The slot being written next is never handed out, so at most capacity - 1 samples
+ * are readable.
+ *
+ * Plain C++ (no Arduino headers) so it also builds on the host.
+ */
+class MotionRing {
+public:
+  MotionRing(MotionSample* storage, uint32_t capacity);
+
+  void push(const MotionSample& s);
+
+  uint32_t capacity() const { return _capacity; }
+  uint32_t headSeq() const { return _head.load(std::memory_order_acquire); }  // seq the next push will get
+  uint32_t oldestSeq() const;                                 // oldest seq still readable
+
+  // True if seq was already overwritten (the reader fell more than a ring behind)
+  bool overrun(uint32_t seq) const { return (int32_t)(oldestSeq() - seq) > 0; }
+
+  // Number of samples from seq up to head (0 if seq is at/after head)
+  uint32_t availableFrom(uint32_t seq) const;
+
+  // Copy sample seq into out. False if it was overwritten or not written yet.
+  bool read(uint32_t seq, MotionSample& out) const;
+
+private:
+  MotionSample* _storage;
+  uint32_t _capacity;
+  std::atomic<uint32_t> _head{0};
+  std::atomic<uint32_t> _count{0};
+
+  uint32_t readable() const;
+};
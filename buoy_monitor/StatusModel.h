@@ -42,5 +42,7 @@ struct WeatherSnapshot {
 
   float humidity = NAN;
   bool humidityValid = false;
+
+  uint32_t updatedAtS = 0;  // UTC seconds of the NWS fetch, 0 if the clock was unsynced
 };
 
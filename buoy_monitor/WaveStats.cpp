@@ -0,0 +1,276 @@
+#include "WaveStats.h"
+#include <math.h>
+#include <string.h>
+
+static constexpr float TWO_PI_F = 6.28318531f;
+
+// ================= P2Quantile =================
+
+P2Quantile::P2Quantile(float p)
+: _p(p) {
+  reset();
+}
+
+void P2Quantile::reset() {
+  _count = 0;
+  for (int i = 0; i < 5; i++) {
+    _q[i] = 0.0f;
+    _n[i] = i;
+  }
+  _np[0] = 0.0f;
+  _np[1] = 2.0f * _p;
+  _np[2] = 4.0f * _p;
+  _np[3] = 2.0f + 2.0f * _p;
+  _np[4] = 4.0f;
+  _dn[0] = 0.0f;
+  _dn[1] = _p / 2.0f;
+  _dn[2] = _p;
+  _dn[3] = (1.0f + _p) / 2.0f;
+  _dn[4] = 1.0f;
+}
+
+void P2Quantile::add(float x) {
+  // First five samples: insertion sort into the markers
+  if (_count < 5) {
+    int i = (int)_count++;
+    while (i > 0 && _q[i - 1] > x) {
+      _q[i] = _q[i - 1];
+      i--;
+    }
+    _q[i] = x;
+    return;
+  }
+  _count++;
+
+  // Find the cell containing x, stretching the extremes if needed
+  int k;
+  if (x < _q[0]) {
+    _q[0] = x;
+    k = 0;
+  } else if (x >= _q[4]) {
+    _q[4] = x;
+    k = 3;
+  } else {
+    k = 0;
+    while (k < 3 && x >= _q[k + 1]) k++;
+  }
+
+  for (int i = k + 1; i < 5; i++) _n[i]++;
+  for (int i = 0; i < 5; i++) _np[i] += _dn[i];
+
+  // Adjust the three middle markers
+  for (int i = 1; i <= 3; i++) {
+    float d = _np[i] - (float)_n[i];
+    if ((d >= 1.0f && _n[i + 1] - _n[i] > 1) || (d <= -1.0f && _n[i - 1] - _n[i] < -1)) {
+      int s = (d > 0.0f) ? 1 : -1;
+
+      // Piecewise-parabolic prediction
+      float nm = (float)_n[i - 1], ni = (float)_n[i], np = (float)_n[i + 1];
+      float qp = _q[i] + s / (np - nm) *
+                 ((ni - nm + s) * (_q[i + 1] - _q[i]) / (np - ni) +
+                  (np - ni - s) * (_q[i] - _q[i - 1]) / (ni - nm));
+
+      if (_q[i - 1] < qp && qp < _q[i + 1]) {
+        _q[i] = qp;
+      } else {
+        // Fall back to linear
+        _q[i] += s * (_q[i + s] - _q[i]) / (float)(_n[i + s] - _n[i]);
+      }
+      _n[i] += s;
+    }
+  }
+}
+
+float P2Quantile::value() const {
+  if (_count == 0) return NAN;
+  if (_count < 5) {
+    // Markers are sorted: nearest-rank on the few samples we have
+    int idx = (int)(_p * (_count - 1) + 0.5f);
+    return _q[idx];
+  }
+  return _q[2];
+}
+
+// ================= WaveStatsHorizon =================
+
+WaveStatsHorizon::WaveStatsHorizon()
+: _p90(0.90f), _p99(0.99f) {
+  clear();
+}
+
+void WaveStatsHorizon::begin(uint32_t horizonMs) {
+  _horizonMs = horizonMs;
+  _started = false;
+  _summary = WaveStatsSummary();
+  _summary.horizonMs = horizonMs;
+  clear();
+}
+
+void WaveStatsHorizon::clear() {
+  _p90.reset();
+  _p99.reset();
+  _waves = 0;
+  _rejected = 0;
+  _heightSum = 0.0f;
+  _hmax = 0.0f;
+  memset(_binCount, 0, sizeof(_binCount));
+  memset(_binSum, 0, sizeof(_binSum));
+}
+
+void WaveStatsHorizon::addSample(uint32_t tMs, float absAcc) {
+  if (!_started) {
+    _startMs = tMs;
+    _started = true;
+  }
+
+  // Tumbling window: publish the finished horizon, start a fresh one
+  if (tMs - _startMs >= _horizonMs) {
+    publish();
+    clear();
+    _startMs = tMs;
+  }
+
+  _p90.add(absAcc);
+  _p99.add(absAcc);
+}
+
+void WaveStatsHorizon::addWave(float heightM) {
+  if (!(heightM > 0.0f)) return;
+
+  static const float LOG_MIN = logf(HEIGHT_MIN_M);
+  static const float BIN_SCALE = HEIGHT_BINS / (logf(HEIGHT_MAX_M) - logf(HEIGHT_MIN_M));
+
+  int bin = (heightM <= HEIGHT_MIN_M) ? 0 : (int)((logf(heightM) - LOG_MIN) * BIN_SCALE);
+  if (bin >= HEIGHT_BINS) bin = HEIGHT_BINS - 1;
+
+  _binCount[bin]++;
+  _binSum[bin] += heightM;
+  _waves++;
+  _heightSum += heightM;
+  if (heightM > _hmax) _hmax = heightM;
+}
+
+float WaveStatsHorizon::significantHeight() const {
+  if (_waves == 0) return NAN;
+
+  // Mean of the highest third, walking bins from the top
+  float want = _waves / 3.0f;
+  if (want < 1.0f) want = 1.0f;
+  float taken = 0.0f;
+  float sum = 0.0f;
+
+  for (int b = HEIGHT_BINS - 1; b >= 0 && taken < want; b--) {
+    if (_binCount[b] == 0) continue;
+    float c = (float)_binCount[b];
+    float use = (taken + c <= want) ? c : (want - taken);
+    sum += (_binSum[b] / c) * use;
+    taken += use;
+  }
+  return sum / taken;
+}
+
+void WaveStatsHorizon::publish() {
+  _summary.valid = true;
+  _summary.seq++;
+  _summary.horizonMs = _horizonMs;
+  _summary.waves = _waves;
+  _summary.rejected = _rejected;
+  _summary.h13 = significantHeight();
+  _summary.hmax = (_waves > 0) ? _hmax : NAN;
+  _summary.hmean = (_waves > 0) ? (_heightSum / _waves) : NAN;
+  _summary.accP90 = _p90.value();
+  _summary.accP99 = _p99.value();
+}
+
+// ================= WaveStats =================
+
+WaveStats::WaveStats() {}
+
+void WaveStats::begin(const uint32_t* horizonMs, int horizons, const WaveStatsConfig& cfg) {
+  if (horizons > MAX_HORIZONS) horizons = MAX_HORIZONS;
+  _horizons = horizons;
+  for (int i = 0; i < _horizons; i++) _h[i].begin(horizonMs[i]);
+
+  _cfg = cfg;
+  if (_cfg.sampleRateHz == 0) _cfg.sampleRateHz = 50;
+  _minPeriodMs = (uint32_t)(_cfg.minPeriodS * 1000.0f);
+  _maxPeriodMs = (uint32_t)(_cfg.maxPeriodS * 1000.0f);
+  _gapMs = motionGapMs(_cfg.sampleRateHz);
+  _cursorValid = false;
+  _haveLast = false;
+  _armed = false;
+  _inWave = false;
+}
+
+void WaveStats::poll(const MotionRing& ring) {
+  if (!_cursorValid) {
+    _nextSeq = ring.headSeq();
+    _cursorValid = true;
+  }
+
+  // Fell behind the ring: skip ahead, the tMs jump drops the wave in progress
+  if (ring.overrun(_nextSeq)) _nextSeq = ring.oldestSeq();
+
+  MotionSample s;
+  while (ring.read(_nextSeq, s)) {
+    _nextSeq++;
+    addSample(s);
+  }
+}
+
+void WaveStats::addSample(const MotionSample& s) {
+  float a = s.aLP;
+
+  // Sampling gap: the wave in progress has a hole, its period and range are wrong
+  bool gap = _haveLast && (s.tMs - _lastTMs) > _gapMs;
+  if (gap) {
+    _inWave = false;
+    _armed = false;
+  }
+
+  // Impact: same thresholds as the event detector, on the unfiltered signal
+  float jerk = (_haveLast && !gap) ? fabsf(s.aVert - _lastAVert) * _cfg.sampleRateHz : 0.0f;
+  bool impact = fabsf(s.aVert) >= _cfg.spikeAbs || jerk >= _cfg.spikeJerk;
+
+  _lastTMs = s.tMs;
+  _lastAVert = s.aVert;
+  _haveLast = true;
+
+  for (int i = 0; i < _horizons; i++) _h[i].addSample(s.tMs, fabsf(a));
+
+  if (a < -_cfg.hysteresis) _armed = true;
+
+  if (_armed && a >= 0.0f) {
+    _armed = false;
+    uint32_t T = s.tMs - _waveStartMs;
+
+    if (_inWave && T < _minPeriodMs) {
+      // Too short to be a wave: noise on the current one, keep accumulating
+    } else {
+      if (_inWave && T <= _maxPeriodMs) {
+        if (_impact || (_aMax - _aMin) > _cfg.maxRange) {
+          // An impact would turn into a phantom height; keep it out of H1/3 / Hmax
+          for (int i = 0; i < _horizons; i++) _h[i].addRejected();
+        } else {
+          float w = TWO_PI_F / (T / 1000.0f);
+          float height = (_aMax - _aMin) / (w * w);
+          for (int i = 0; i < _horizons; i++) _h[i].addWave(height);
+        }
+      }
+
+      // Start the next wave at this crossing
+      _inWave = true;
+      _waveStartMs = s.tMs;
+      _aMax = a;
+      _aMin = a;
+      _impact = impact;
+      return;
+    }
+  }
+
+  if (_inWave) {
+    if (a > _aMax) _aMax = a;
+    if (a < _aMin) _aMin = a;
+    if (impact) _impact = true;
+  }
+}
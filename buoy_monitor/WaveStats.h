@@ -0,0 +1,148 @@
+#pragma once
+#include <stdint.h>
+#include <math.h>
+#include "MotionRing.h"
+
+/**
+ * @brief P-squared streaming quantile estimator (Jain & Chlamtac).
+ *
+ * Five markers, O(1) per sample, no stored samples.
+ */
+class P2Quantile {
+public:
+  explicit P2Quantile(float p = 0.5f);
+
+  void reset();
+  void add(float x);
+  float value() const;          // NAN until the first sample
+  uint32_t count() const { return _count; }
+
+private:
+  float _p;
+  uint32_t _count = 0;
+  float _q[5];                  // marker heights
+  int32_t _n[5];                // marker positions
+  float _np[5];                 // desired positions
+  float _dn[5];                 // desired position increments
+};
+
+/**
+ * @brief Tail statistics for one completed horizon.
+ */
+struct WaveStatsSummary {
+  bool valid = false;
+  uint32_t seq = 0;             // bumped every time a new summary is published
+  uint32_t horizonMs = 0;
+  uint32_t waves = 0;           // zero-up-crossing waves counted
+  uint32_t rejected = 0;        // waves dropped as impacts (spike or range beyond swell)
+  float h13 = NAN;              // significant height H1/3 (m)
+  float hmax = NAN;             // largest single wave (m)
+  float hmean = NAN;            // mean wave height (m)
+  float accP90 = NAN;           // p90 of |aLP| (m/s^2)
+  float accP99 = NAN;           // p99 of |aLP| (m/s^2)
+};
+
+/**
+ * @brief One tumbling statistics horizon (e.g. 10 min).
+ *
+ * Heights go into a fixed log-spaced histogram (count + sum per bin), so H1/3 is
+ * the mean of the top third taken from the highest bins down. Fixed memory.
+ */
+class WaveStatsHorizon {
+public:
+  static constexpr int HEIGHT_BINS = 48;
+  static constexpr float HEIGHT_MIN_M = 0.01f;
+  static constexpr float HEIGHT_MAX_M = 30.0f;
+
+  WaveStatsHorizon();
+
+  void begin(uint32_t horizonMs);
+  void addSample(uint32_t tMs, float absAcc);
+  void addWave(float heightM);
+  void addRejected() { _rejected++; }
+
+  const WaveStatsSummary& summary() const { return _summary; }
+
+private:
+  uint32_t _horizonMs = 0;
+  uint32_t _startMs = 0;
+  bool _started = false;
+
+  P2Quantile _p90;
+  P2Quantile _p99;
+  uint32_t _waves = 0;
+  uint32_t _rejected = 0;
+  float _heightSum = 0.0f;
+  float _hmax = 0.0f;
+  uint32_t _binCount[HEIGHT_BINS];
+  float _binSum[HEIGHT_BINS];
+
+  WaveStatsSummary _summary;
+
+  void publish();
+  void clear();
+  float significantHeight() const;
+};
+
+/**
+ * @brief Wave detection settings (see AppConfig.h for the values in use).
+ */
+struct WaveStatsConfig {
+  uint16_t sampleRateHz = 50;
+  float minPeriodS = 1.0f;
+  float maxPeriodS = 25.0f;
+  float hysteresis = 0.05f;     // m/s^2 below zero to re-arm
+  float maxRange = 9.81f;       // aLP max - min of one wave; swell stays within +-g/2
+  float spikeAbs = 12.0f;       // |aVert| of an impact (m/s^2)
+  float spikeJerk = 400.0f;     // |d aVert / dt| of an impact (m/s^3)
+};
+
+/**
+ * @brief Wave-by-wave height tracking and tail statistics from the acquisition ring.
+ *
+ * Each zero-up-crossing wave of the filtered vertical acceleration gets a height
+ * estimate H = (aMax - aMin) / (2*pi/T)^2, i.e. the displacement of a sinusoid
+ * with the same period and acceleration range. An up-crossing only counts after
+ * the signal dipped below -hysteresis, and crossings closer than minPeriodS are
+ * treated as noise riding on the current wave. A step longer than motionGapMs()
+ * (samples missing after a ring overrun) drops the wave in progress. A wave holding
+ * an impact (|aVert| or jerk at the event thresholds) or whose acceleration range
+ * exceeds maxRange is counted as rejected instead of producing a phantom height.
+ * O(1) per sample; plain C++ (no Arduino headers).
+ */
+class WaveStats {
+public:
+  static constexpr int MAX_HORIZONS = 2;
+
+  WaveStats();
+
+  void begin(const uint32_t* horizonMs, int horizons, const WaveStatsConfig& cfg);
+  void poll(const MotionRing& ring);   // call every loop iteration
+
+  int horizonCount() const { return _horizons; }
+  const WaveStatsSummary& summary(int i) const { return _h[i].summary(); }
+
+private:
+  WaveStatsHorizon _h[MAX_HORIZONS];
+  int _horizons = 0;
+  WaveStatsConfig _cfg;
+  uint32_t _minPeriodMs = 1000;
+  uint32_t _maxPeriodMs = 25000;
+  uint32_t _gapMs = 30;         // longer sample steps are gaps
+
+  uint32_t _nextSeq = 0;
+  bool _cursorValid = false;
+  uint32_t _lastTMs = 0;
+  float _lastAVert = 0.0f;
+  bool _haveLast = false;
+
+  // Current wave
+  bool _armed = false;          // saw a trough below -hysteresis since the last crossing
+  bool _inWave = false;
+  uint32_t _waveStartMs = 0;
+  float _aMax = 0.0f;
+  float _aMin = 0.0f;
+  bool _impact = false;         // current wave holds an impact spike
+
+  void addSample(const MotionSample& s);
+};
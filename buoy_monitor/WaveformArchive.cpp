@@ -0,0 +1,162 @@
+#include <SD.h>
+#include <SPI.h>
+#include "WaveformArchive.h"
+
+static const char* ARCHIVE_DIR = "/wave";
+
+WaveformArchive::WaveformArchive(const ClockService& clock, uint8_t csPin, uint16_t sampleRateHz,
+                                 uint16_t blockSamples, uint32_t maxFileBytes)
+: _clock(clock), _csPin(csPin), _rateHz(sampleRateHz), _maxFileBytes(maxFileBytes) {
+  if (blockSamples < 2) blockSamples = 2;
+  if (blockSamples > WAVE_BLOCK_MAX_SAMPLES) blockSamples = WAVE_BLOCK_MAX_SAMPLES;
+  _blockSamples = blockSamples;
+
+  // Samples missing (ring overrun) start a new block, so spanMs stays exact
+  _gapMs = motionGapMs(sampleRateHz);
+}
+
+bool WaveformArchive::begin(const MotionRing& ring) {
+  _ring = &ring;
+  if (!SD.begin(_csPin)) {
+    Serial.println("Archive: SD mount failed");
+    return false;
+  }
+
+  if (!SD.exists(ARCHIVE_DIR)) SD.mkdir(ARCHIVE_DIR);
+
+  // Continue numbering after the highest existing file
+  File dir = SD.open(ARCHIVE_DIR);
+  if (dir) {
+    File f = dir.openNextFile();
+    while (f) {
+      uint32_t idx = (uint32_t)strtoul(f.name(), nullptr, 10);
+      if (idx + 1 > _fileIndex) _fileIndex = idx + 1;
+      f = dir.openNextFile();
+    }
+    dir.close();
+  }
+
+  _ready = openNextFile();
+  if (!_ready) return false;
+
+  if (_task == nullptr &&
+      xTaskCreatePinnedToCore(taskEntry, "wave_archive", ARCHIVE_TASK_STACK, this,
+                              ARCHIVE_TASK_PRIORITY, &_task, ARCHIVE_TASK_CORE) != pdPASS) {
+    _task = nullptr;
+    _file.close();
+    _ready = false;
+  }
+  return _ready;
+}
+
+// Archive task: drains the ring and does all SD I/O, independent of loop()
+void WaveformArchive::taskEntry(void* arg) {
+  WaveformArchive* self = static_cast<WaveformArchive*>(arg);
+  for (;;) {
+    self->poll();
+    vTaskDelay(pdMS_TO_TICKS(ARCHIVE_POLL_MS));
+  }
+}
+
+bool WaveformArchive::openNextFile() {
+  if (_file) _file.close();
+
+  char path[24];
+  snprintf(path, sizeof(path), "%s/%06lu.bwa", ARCHIVE_DIR, (unsigned long)_fileIndex++);
+  _file = SD.open(path, FILE_WRITE);
+  _fileBytes = 0;
+
+  if (!_file) {
+    Serial.printf("Archive: cannot open %s\n", path);
+    return false;
+  }
+  Serial.printf("Archive: writing %s\n", path);
+  return true;
+}
+
+void WaveformArchive::poll() {
+  if (!_ready) return;
+  const MotionRing& ring = *_ring;
+
+  if (!_cursorValid) {
+    _nextSeq = ring.headSeq();
+    _cursorValid = true;
+  }
+
+  // New clock sync: anchor it so earlier unsynced blocks can be dated
+  if (_clock.syncCount() != _clockSyncs) {
+    _clockSyncs = _clock.syncCount();
+    writeTimeAnchor();
+  }
+
+  // Ring overwrote samples we never read: close the block, count the gap
+  if (ring.overrun(_nextSeq)) {
+    uint32_t oldest = ring.oldestSeq();
+    _samplesDropped += oldest - _nextSeq;
+    _nextSeq = oldest;
+    writeBlock();
+  }
+
+  MotionSample s;
+  while (ring.read(_nextSeq, s)) {
+    _nextSeq++;
+
+    if (_n > 0 && (s.tMs - _lastSampleMs) > _gapMs) writeBlock();
+
+    if (_n == 0) {
+      _blockStartMs = s.tMs;
+      _blockEpochMs = _clock.epochMsAt(s.tMs);
+    }
+
+    int16_t* d = &_xyz[_n * 3];
+    d[0] = waveQuantize(s.ax);
+    d[1] = waveQuantize(s.ay);
+    d[2] = waveQuantize(s.az);
+    _n++;
+    _lastSampleMs = s.tMs;
+
+    if (_n >= _blockSamples) writeBlock();
+  }
+}
+
+void WaveformArchive::writeBlock() {
+  if (_n == 0) return;
+
+  size_t len = waveEncodeBlock(_xyz, _n, _rateHz, _blockStartMs, _lastSampleMs,
+                               _blockEpochMs, _out, sizeof(_out));
+  uint16_t n = _n;
+  _n = 0;
+  if (len == 0) return;
+
+  if (!append(_out, len)) return;
+
+  _blocksWritten++;
+  _rawBytes += (uint32_t)n * 6;
+  _storedBytes += len;
+}
+
+void WaveformArchive::writeTimeAnchor() {
+  uint32_t ms = millis();
+  uint8_t anchor[WAVE_BLOCK_HEADER_BYTES];
+  size_t len = waveEncodeTimeAnchor(ms, _clock.epochMsAt(ms), anchor, sizeof(anchor));
+  if (len > 0) append(anchor, len);
+}
+
+bool WaveformArchive::append(const uint8_t* data, size_t len) {
+  if (_fileBytes + len > _maxFileBytes && !openNextFile()) {
+    _ready = false;
+    return false;
+  }
+
+  size_t wrote = _file.write(data, len);
+  _file.flush();
+  if (wrote != len) {
+    Serial.println("Archive: SD write failed, archive stopped");
+    _file.close();
+    _ready = false;
+    return false;
+  }
+
+  _fileBytes += len;
+  return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include "AppConfig.h"
+#include "ClockService.h"
+#include "MotionRing.h"
+#include "WaveformCodec.h"
+
+/**
+ * @brief Archive mode: writes raw 3-axis samples to SD as compressed blocks.
+ *
+ * Drains the acquisition ring with its own cursor, quantizes to 0.01 m/s^2,
+ * and appends one WaveformCodec block per blockSamples samples to
+ * /wave/NNNNNN.bwa (a new file every maxFileBytes). Each block is flushed
+ * so a power loss costs at most one block. Each clock sync appends a time anchor
+ * block so blocks written while unsynced can be dated by the decoder.
+ *
+ * The ring is drained by the archive's own task (started by begin()), so blocking
+ * HTTPS/NWS calls in loop() cost no samples. Only an SD write stalling longer than
+ * the ring (MOTION_RING_SAMPLES: ~20 s at 50 Hz, ~10 s at 100 Hz) loses data; those
+ * samples are counted in samplesDropped() and the block is closed there.
+ */
+class WaveformArchive {
+public:
+  WaveformArchive(const ClockService& clock, uint8_t csPin, uint16_t sampleRateHz,
+                  uint16_t blockSamples, uint32_t maxFileBytes);
+
+  bool begin(const MotionRing& ring);  // mount SD, open the next file, start the archive task
+
+  bool isReady() const { return _ready; }
+  uint32_t blocksWritten() const { return _blocksWritten; }
+  uint32_t rawBytes() const { return _rawBytes; }          // int16 xyz equivalent
+  uint32_t storedBytes() const { return _storedBytes; }
+  uint32_t samplesDropped() const { return _samplesDropped; }
+
+private:
+  static void taskEntry(void* arg);
+  void poll();
+
+  const ClockService& _clock;
+  const MotionRing* _ring = nullptr;
+  TaskHandle_t _task = nullptr;
+  uint32_t _clockSyncs = 0;
+  uint8_t _csPin;
+  uint16_t _rateHz;
+  uint16_t _blockSamples;
+  uint32_t _maxFileBytes;
+  uint32_t _gapMs;
+
+  bool _ready = false;
+  File _file;
+  uint32_t _fileIndex = 0;
+  uint32_t _fileBytes = 0;
+
+  uint32_t _nextSeq = 0;
+  bool _cursorValid = false;
+
+  // Current block
+  int16_t _xyz[WAVE_BLOCK_MAX_SAMPLES * 3];
+  uint16_t _n = 0;
+  uint32_t _blockStartMs = 0;
+  int64_t _blockEpochMs = 0;
+  uint32_t _lastSampleMs = 0;
+
+  uint8_t _out[WAVE_BLOCK_MAX_BYTES];
+
+  uint32_t _blocksWritten = 0;
+  uint32_t _rawBytes = 0;
+  uint32_t _storedBytes = 0;
+  uint32_t _samplesDropped = 0;
+
+  bool openNextFile();
+  void writeBlock();
+  void writeTimeAnchor();
+  bool append(const uint8_t* data, size_t len);
+};
@@ -0,0 +1,212 @@
+#include "WaveformCodec.h"
+#include <string.h>
+#include <math.h>
+
+static const uint8_t BLOCK_MAGIC[4] = {'B', 'Y', 'W', 'A'};
+
+// ---------- Little-endian field helpers ----------
+static void put16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void put32(uint8_t* p, uint32_t v) { put16(p, (uint16_t)v); put16(p + 2, (uint16_t)(v >> 16)); }
+static void put64(uint8_t* p, uint64_t v) { put32(p, (uint32_t)v); put32(p + 4, (uint32_t)(v >> 32)); }
+static uint16_t get16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t get32(const uint8_t* p) { return get16(p) | ((uint32_t)get16(p + 2) << 16); }
+static uint64_t get64(const uint8_t* p) { return get32(p) | ((uint64_t)get32(p + 4) << 32); }
+
+static uint32_t zigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+static int32_t unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+static uint8_t bitWidth(uint32_t v) {
+  uint8_t b = 0;
+  while (v) { b++; v >>= 1; }
+  return b;
+}
+
+static size_t packedBytes(uint16_t count, uint8_t bits) {
+  return ((size_t)count * bits + 7) / 8;
+}
+
+int16_t waveQuantize(float mps2) {
+  float c = roundf(mps2 * WAVE_COUNTS_PER_MPS2);
+  if (c > 32767.0f) return 32767;
+  if (c < -32768.0f) return -32768;
+  return (int16_t)c;
+}
+
+uint32_t waveCrc32(uint32_t crc, const uint8_t* data, size_t len) {
+  // Nibble table: small enough for flash, ~2x faster than bitwise
+  static const uint32_t T[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+  crc = ~crc;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    crc = (crc >> 4) ^ T[crc & 0x0F];
+    crc = (crc >> 4) ^ T[crc & 0x0F];
+  }
+  return ~crc;
+}
+
+size_t waveEncodeBlock(const int16_t* xyz, uint16_t n,
+                       uint16_t sampleRateHz, uint32_t startMs, uint32_t endMs,
+                       int64_t startEpochMs, uint8_t* out, size_t outCap) {
+  if (n == 0 || n > WAVE_BLOCK_MAX_SAMPLES) return 0;
+
+  // 1) Bit width per axis from the largest zigzag delta
+  uint8_t bits[3] = {0, 0, 0};
+  for (int a = 0; a < 3; a++) {
+    uint32_t maxZ = 0;
+    for (uint16_t i = 1; i < n; i++) {
+      uint32_t z = zigzag((int32_t)xyz[i * 3 + a] - (int32_t)xyz[(i - 1) * 3 + a]);
+      if (z > maxZ) maxZ = z;
+    }
+    bits[a] = bitWidth(maxZ);
+  }
+
+  size_t payload = 0;
+  for (int a = 0; a < 3; a++) payload += packedBytes(n - 1, bits[a]);
+  size_t total = WAVE_BLOCK_HEADER_BYTES + payload;
+  if (total > outCap) return 0;
+
+  // 2) Header
+  memset(out, 0, WAVE_BLOCK_HEADER_BYTES);
+  memcpy(out, BLOCK_MAGIC, 4);
+  out[4] = WAVE_BLOCK_VERSION;
+  out[5] = WAVE_BLOCK_TYPE_DATA;
+  put16(out + 6, n);
+  put16(out + 8, sampleRateHz);
+  out[10] = bits[0];
+  out[11] = bits[1];
+  out[12] = bits[2];
+  put16(out + 14, (uint16_t)payload);
+  put32(out + 16, startMs);
+  put64(out + 20, (uint64_t)startEpochMs);
+  put16(out + 28, (uint16_t)xyz[0]);
+  put16(out + 30, (uint16_t)xyz[1]);
+  put16(out + 32, (uint16_t)xyz[2]);
+  uint32_t span = endMs - startMs;
+  put16(out + 34, (uint16_t)(span > 0xFFFF ? 0xFFFF : span));
+
+  // 3) Payload: axis-planar bit-packed zigzag deltas
+  uint8_t* p = out + WAVE_BLOCK_HEADER_BYTES;
+  for (int a = 0; a < 3; a++) {
+    size_t bytes = packedBytes(n - 1, bits[a]);
+    memset(p, 0, bytes);
+
+    uint64_t acc = 0;
+    int accBits = 0;
+    uint8_t* w = p;
+    for (uint16_t i = 1; i < n && bits[a] > 0; i++) {
+      acc |= (uint64_t)zigzag((int32_t)xyz[i * 3 + a] - (int32_t)xyz[(i - 1) * 3 + a]) << accBits;
+      accBits += bits[a];
+      while (accBits >= 8) {
+        *w++ = (uint8_t)acc;
+        acc >>= 8;
+        accBits -= 8;
+      }
+    }
+    if (accBits > 0) *w = (uint8_t)acc;
+    p += bytes;
+  }
+
+  put32(out + 36, waveCrc32(0, out, total));
+  return total;
+}
+
+size_t waveEncodeTimeAnchor(uint32_t tMs, int64_t epochMs, uint8_t* out, size_t outCap) {
+  if (outCap < WAVE_BLOCK_HEADER_BYTES) return 0;
+
+  memset(out, 0, WAVE_BLOCK_HEADER_BYTES);
+  memcpy(out, BLOCK_MAGIC, 4);
+  out[4] = WAVE_BLOCK_VERSION;
+  out[5] = WAVE_BLOCK_TYPE_TIME;
+  put32(out + 16, tMs);
+  put64(out + 20, (uint64_t)epochMs);
+  put32(out + 36, waveCrc32(0, out, WAVE_BLOCK_HEADER_BYTES));
+  return WAVE_BLOCK_HEADER_BYTES;
+}
+
+size_t waveParseHeader(const uint8_t* in, size_t len, WaveBlockInfo& info) {
+  if (len < WAVE_BLOCK_HEADER_BYTES) return 0;
+  if (memcmp(in, BLOCK_MAGIC, 4) != 0 || in[4] != WAVE_BLOCK_VERSION) return 0;
+
+  info.type = in[5];
+  info.sampleCount = get16(in + 6);
+  info.sampleRateHz = get16(in + 8);
+  info.bits[0] = in[10];
+  info.bits[1] = in[11];
+  info.bits[2] = in[12];
+  info.payloadBytes = get16(in + 14);
+  info.startMs = get32(in + 16);
+  info.spanMs = get16(in + 34);
+  info.startEpochMs = (int64_t)get64(in + 20);
+
+  if (info.type == WAVE_BLOCK_TYPE_TIME) {
+    return (info.sampleCount == 0 && info.payloadBytes == 0) ? WAVE_BLOCK_HEADER_BYTES : 0;
+  }
+  if (info.type != WAVE_BLOCK_TYPE_DATA) return 0;
+  if (info.sampleCount == 0 || info.sampleCount > WAVE_BLOCK_MAX_SAMPLES) return 0;
+  for (int a = 0; a < 3; a++) {
+    if (info.bits[a] > 17) return 0;
+  }
+
+  size_t expect = 0;
+  for (int a = 0; a < 3; a++) expect += packedBytes(info.sampleCount - 1, info.bits[a]);
+  if (expect != info.payloadBytes) return 0;
+
+  return WAVE_BLOCK_HEADER_BYTES + info.payloadBytes;
+}
+
+bool waveCheckCrc(const uint8_t* in, size_t total) {
+  // CRC covers the header with the crc field zeroed
+  uint8_t hdr[WAVE_BLOCK_HEADER_BYTES];
+  memcpy(hdr, in, WAVE_BLOCK_HEADER_BYTES);
+  put32(hdr + 36, 0);
+  uint32_t crc = waveCrc32(0, hdr, WAVE_BLOCK_HEADER_BYTES);
+  crc = waveCrc32(crc, in + WAVE_BLOCK_HEADER_BYTES, total - WAVE_BLOCK_HEADER_BYTES);
+  return crc == get32(in + 36);
+}
+
+bool waveDecodeBlock(const uint8_t* in, size_t len, WaveBlockInfo& info,
+                     int16_t* xyzOut, uint16_t maxSamples) {
+  size_t total = waveParseHeader(in, len, info);
+  if (total == 0 || total > len) return false;
+  if (info.type != WAVE_BLOCK_TYPE_DATA || info.sampleCount > maxSamples) return false;
+  if (!waveCheckCrc(in, total)) return false;
+
+  uint16_t n = info.sampleCount;
+  const uint8_t* p = in + WAVE_BLOCK_HEADER_BYTES;
+  for (int a = 0; a < 3; a++) {
+    int32_t v = (int16_t)get16(in + 28 + a * 2);
+    xyzOut[a] = (int16_t)v;
+
+    uint8_t b = info.bits[a];
+    uint32_t mask = (b >= 32) ? 0xFFFFFFFFu : ((1u << b) - 1u);
+    uint64_t acc = 0;
+    int accBits = 0;
+    const uint8_t* r = p;
+    for (uint16_t i = 1; i < n; i++) {
+      uint32_t z = 0;
+      if (b > 0) {
+        while (accBits < b) {
+          acc |= (uint64_t)(*r++) << accBits;
+          accBits += 8;
+        }
+        z = (uint32_t)acc & mask;
+        acc >>= b;
+        accBits -= b;
+      }
+      v += unzigzag(z);
+      xyzOut[i * 3 + a] = (int16_t)v;
+    }
+    p += packedBytes(n - 1, b);
+  }
+  return true;
+}
+
+double waveSampleOffsetMs(const WaveBlockInfo& info, uint16_t i) {
+  if (info.sampleCount > 1 && info.spanMs != 0 && info.spanMs != 0xFFFF) {
+    return (double)info.spanMs * i / (info.sampleCount - 1);
+  }
+  return info.sampleRateHz ? (double)i * 1000.0 / info.sampleRateHz : 0.0;
+}
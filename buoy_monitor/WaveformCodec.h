@@ -0,0 +1,106 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @file WaveformCodec.h
+ * @brief Block codec for raw 3-axis accelerometer records (archive mode).
+ *
+ * Samples are stored as int16 counts of 0.01 m/s^2 (the BNO055 native LSB).
+ * Each block holds up to WAVE_BLOCK_MAX_SAMPLES samples:
+ *
+ *   header (40 bytes, little-endian)
+ *     0  "BYWA" magic           16 u32 startMs (millis of first sample)
+ *     4  u8  version            20 i64 startEpochMs (UTC ms, 0 = clock unsynced)
+ *     5  u8  type ('D' / 'T')   28 i16 first sample x, y, z
+ *     6  u16 sampleCount        34 u16 spanMs (last - first sample, 0xFFFF = longer)
+ *     8  u16 sampleRateHz       36 u32 CRC-32 of header (crc = 0) + payload
+ *     10 u8  bits x, y, z
+ *     13 u8  reserved
+ *     14 u16 payloadBytes
+ *
+ *   payload: per axis, (sampleCount - 1) zigzag deltas bit-packed LSB-first
+ *            with that axis' bit width. Axes follow each other byte-aligned.
+ *
+ * spanMs lets the decoder place samples on their real time base even if the sampler
+ * ran slightly off its nominal rate; 0 (single sample / unknown) means use the rate.
+ *
+ * A time anchor block ('T', no samples, no payload) records startMs/startEpochMs of
+ * the clock sync so blocks written earlier with startEpochMs = 0 can be dated later.
+ *
+ * Lossless for the quantized values. Plain C++ so the host decoder shares this file.
+ */
+
+static constexpr uint16_t WAVE_BLOCK_MAX_SAMPLES = 256;
+static constexpr size_t WAVE_BLOCK_HEADER_BYTES = 40;
+static constexpr uint8_t WAVE_BLOCK_VERSION = 1;
+static constexpr uint8_t WAVE_BLOCK_TYPE_DATA = 'D';
+static constexpr uint8_t WAVE_BLOCK_TYPE_TIME = 'T';
+static constexpr float WAVE_COUNTS_PER_MPS2 = 100.0f;  // 1 count = 0.01 m/s^2
+
+// Worst case: 17-bit deltas on every axis
+static constexpr size_t WAVE_BLOCK_MAX_BYTES =
+  WAVE_BLOCK_HEADER_BYTES + 3 * (((WAVE_BLOCK_MAX_SAMPLES - 1) * 17 + 7) / 8);
+
+/**
+ * @brief Decoded block header.
+ */
+struct WaveBlockInfo {
+  uint8_t type = 0;
+  uint16_t sampleCount = 0;
+  uint16_t sampleRateHz = 0;
+  uint32_t startMs = 0;
+  uint16_t spanMs = 0;
+  int64_t startEpochMs = 0;
+  uint16_t payloadBytes = 0;
+  uint8_t bits[3] = {0, 0, 0};
+};
+
+/**
+ * @brief Convert m/s^2 to archive counts (rounded, clamped to int16).
+ */
+int16_t waveQuantize(float mps2);
+
+/**
+ * @brief Standard CRC-32 (IEEE, reflected). Pass 0 to start.
+ */
+uint32_t waveCrc32(uint32_t crc, const uint8_t* data, size_t len);
+
+/**
+ * @brief Encode n interleaved xyz samples into out.
+ * startMs / endMs are the millis() of the first and last sample.
+ * @return bytes written, or 0 if n is out of range or out is too small.
+ */
+size_t waveEncodeBlock(const int16_t* xyz, uint16_t n,
+                       uint16_t sampleRateHz, uint32_t startMs, uint32_t endMs,
+                       int64_t startEpochMs, uint8_t* out, size_t outCap);
+
+/**
+ * @brief Millis offset of sample i of a data block from info.startMs.
+ * Spreads samples over spanMs when known, else uses the nominal rate.
+ */
+double waveSampleOffsetMs(const WaveBlockInfo& info, uint16_t i);
+
+/**
+ * @brief Encode a time anchor block: millis() tMs corresponds to UTC epochMs.
+ * @return bytes written (WAVE_BLOCK_HEADER_BYTES), or 0 if out is too small.
+ */
+size_t waveEncodeTimeAnchor(uint32_t tMs, int64_t epochMs, uint8_t* out, size_t outCap);
+
+/**
+ * @brief Parse the fixed header at in (no CRC check).
+ * @return total block size in bytes, or 0 if this is not a valid header.
+ */
+size_t waveParseHeader(const uint8_t* in, size_t len, WaveBlockInfo& info);
+
+/**
+ * @brief Verify the CRC of a block whose size waveParseHeader() returned.
+ */
+bool waveCheckCrc(const uint8_t* in, size_t total);
+
+/**
+ * @brief Verify and decode one data block into interleaved xyz samples.
+ * @return false on bad magic/size/CRC or if maxSamples is too small.
+ */
+bool waveDecodeBlock(const uint8_t* in, size_t len, WaveBlockInfo& info,
+                     int16_t* xyzOut, uint16_t maxSamples);
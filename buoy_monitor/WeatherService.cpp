@@ -1,8 +1,19 @@
 #include <WiFiClientSecure.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
+#include <Preferences.h>
+#include <time.h>
 #include "WeatherService.h"
 
+static const char* NVS_NAMESPACE = "weather";
+static const time_t MIN_VALID_EPOCH_S = 1704067200;   // 2024-01-01, below = clock unsynced
+
+// UTC seconds from the system clock (set by SNTP), 0 while it is still unsynced
+static uint32_t utcNowS() {
+  time_t t = time(nullptr);
+  return (t >= MIN_VALID_EPOCH_S) ? (uint32_t)t : 0;
+}
+
 /*
   WeatherService.cpp (UPDATED - robust extraction)
 
@@ -367,10 +378,66 @@ bool WeatherService::fetchHourlyPeriod0Streamed(const String& hourlyUrl, Weather
   return true;
 }
 
+/*
+  NVS cache:
+  - hourly URL: skips the /points lookup after a reboot
+  - last snapshot: payloads have weather fields before the first fetch completes
+  - savedAt: UTC seconds of that snapshot (0 = unknown), so a stale cache can be told apart
+*/
+bool WeatherService::loadCache(WeatherSnapshot& out) {
+  Preferences prefs;
+  if (!prefs.begin(NVS_NAMESPACE, true)) return false;
+
+  String url = prefs.getString("hourlyUrl", "");
+  if (url.length() > 0) _hourlyUrlCached = url;
+
+  bool haveSnapshot = prefs.isKey("fc");
+  if (haveSnapshot) {
+    out.shortForecast = prefs.getString("fc", "");
+    out.windMph = prefs.getInt("wind", -1);
+    out.gustMph = prefs.getInt("gust", -1);
+    out.windDirection = prefs.getString("dir", "");
+    out.temperatureF = prefs.getFloat("tempF", NAN);
+    out.temperatureValid = prefs.getBool("tempOk", false);
+    out.humidity = prefs.getFloat("rh", NAN);
+    out.humidityValid = prefs.getBool("rhOk", false);
+    out.weatherStatus = (RiskStatus)prefs.getUChar("status", (uint8_t)RiskStatus::OK);
+    out.updatedAtS = prefs.getULong("savedAt", 0);
+  }
+  prefs.end();
+
+  Serial.printf("Weather cache: url=%s snapshot=%s savedAt=%lu\n",
+                url.length() > 0 ? "yes" : "no", haveSnapshot ? "yes" : "no",
+                (unsigned long)out.updatedAtS);
+  return haveSnapshot;
+}
+
+void WeatherService::saveCache(const WeatherSnapshot& snap) {
+  Preferences prefs;
+  if (!prefs.begin(NVS_NAMESPACE, false)) return;
+
+  // Only rewrite the URL when it changed (saves flash writes)
+  if (prefs.getString("hourlyUrl", "") != _hourlyUrlCached) {
+    prefs.putString("hourlyUrl", _hourlyUrlCached);
+  }
+  prefs.putString("fc", snap.shortForecast);
+  prefs.putInt("wind", snap.windMph);
+  prefs.putInt("gust", snap.gustMph);
+  prefs.putString("dir", snap.windDirection);
+  prefs.putFloat("tempF", snap.temperatureF);
+  prefs.putBool("tempOk", snap.temperatureValid);
+  prefs.putFloat("rh", snap.humidity);
+  prefs.putBool("rhOk", snap.humidityValid);
+  prefs.putUChar("status", (uint8_t)snap.weatherStatus);
+  prefs.putULong("savedAt", snap.updatedAtS);
+  prefs.end();
+}
+
 /*
   Public API:
   - Use cached hourly URL if present
   - If hourly fails, refresh /points once and retry
+  - Successful results are saved to NVS
 */
 bool WeatherService::refresh(WeatherSnapshot& out) {
   if (_hourlyUrlCached.length() == 0 && !fetchPointsAndCacheHourly()) {
@@ -379,6 +446,8 @@ bool WeatherService::refresh(WeatherSnapshot& out) {
 
   for (int attempt = 0; attempt < 2; attempt++) {
     if (fetchHourlyPeriod0Streamed(_hourlyUrlCached, out)) {
+      out.updatedAtS = utcNowS();
+      saveCache(out);
       return true;
     }
 
@@ -7,6 +7,9 @@ public:
   WeatherService(const char* userAgent, float lat, float lon);
   bool refresh(WeatherSnapshot& out);
 
+  // Last hourly URL + snapshot saved in NVS, so boot does not wait for NWS
+  bool loadCache(WeatherSnapshot& out);
+
 private:
   const char* _userAgent;
   float _lat, _lon;
@@ -20,6 +23,7 @@ private:
   RiskStatus classifyWeather(int wind, int gust, const String& fcLower) const;
 
   bool fetchPointsAndCacheHourly();
+  void saveCache(const WeatherSnapshot& snap);
 
   // Stream parse just period[0]
   bool fetchHourlyPeriod0Streamed(const String& hourlyUrl, WeatherSnapshot& out);
@@ -9,55 +9,44 @@ void WifiManager::begin() {
   WiFi.persistent(false);        // avoid writing creds to flash repeatedly
   WiFi.begin(_ssid, _pass);
 
-  Serial.print("Connecting to Wi-Fi");
-  uint32_t t0 = millis();
-  while (WiFi.status() != WL_CONNECTED && (millis() - t0) < 20000UL) {
-    delay(500);
-    Serial.print(".");
-  }
-  Serial.println();
-
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.print("Connected. IP: ");
-    Serial.println(WiFi.localIP());
-  } else {
-    Serial.println("Initial Wi-Fi connection failed.");
-  }
-
+  // Connection completes in the background; ensureConnected() reports it
+  Serial.println("Connecting to Wi-Fi (background)");
   _lastRetryMs = millis();
 }
 
 void WifiManager::ensureConnected() {
-  if (WiFi.status() == WL_CONNECTED) return;
-
   uint32_t now = millis();
-  if ((now - _lastRetryMs) < _retryMs) return;
-  _lastRetryMs = now;
-
-  Serial.println("Wi-Fi disconnected. Reconnecting...");
 
-  // Try lightweight reconnect first
-  WiFi.reconnect();
-
-  uint32_t t0 = millis();
-  while (WiFi.status() != WL_CONNECTED && (millis() - t0) < 5000UL) {
-    delay(100);
+  if (WiFi.status() == WL_CONNECTED) {
+    if (!_wasConnected) {
+      _wasConnected = true;
+      _attempt = 0;
+      Serial.printf("Wi-Fi connected at %lu ms. IP: ", (unsigned long)now);
+      Serial.print(WiFi.localIP());
+      Serial.print("  RSSI: ");
+      Serial.println(WiFi.RSSI());
+    }
+    return;
   }
 
-  // If still not connected, do full begin
-  if (WiFi.status() != WL_CONNECTED) {
-    WiFi.begin(_ssid, _pass);
-    t0 = millis();
-    while (WiFi.status() != WL_CONNECTED && (millis() - t0) < 8000UL) {
-      delay(100);
-    }
+  if (_wasConnected) {
+    _wasConnected = false;
+    _lastRetryMs = now;   // give auto-reconnect one interval first
+    Serial.println("Wi-Fi disconnected.");
+    return;
   }
 
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.print("Reconnected. IP: ");
-    Serial.println(WiFi.localIP());
+  if ((now - _lastRetryMs) < _retryMs) return;
+  _lastRetryMs = now;
+
+  // Alternate a lightweight reconnect with a full begin; never wait here
+  if ((_attempt++ % 2) == 0) {
+    Serial.printf("Wi-Fi reconnecting... status=%d\n", (int)WiFi.status());
+    WiFi.reconnect();
   } else {
-    Serial.printf("Reconnect failed. status=%d\n", (int)WiFi.status());
+    Serial.printf("Wi-Fi restarting connection... status=%d\n", (int)WiFi.status());
+    WiFi.disconnect();
+    WiFi.begin(_ssid, _pass);
   }
 }
 
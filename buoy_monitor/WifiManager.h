@@ -2,6 +2,12 @@
 #include <Arduino.h>
 #include <WiFi.h>
 
+/**
+ * @brief Non-blocking Wi-Fi station management.
+ *
+ * begin() only starts the connection; ensureConnected() is called every loop and
+ * alternates lightweight reconnects and full re-begins every retryMs without waiting.
+ */
 class WifiManager {
 public:
   WifiManager(const char* ssid, const char* pass, uint32_t retryMs);
@@ -14,4 +20,6 @@ private:
   const char* _pass;
   uint32_t _retryMs;
   uint32_t _lastRetryMs;
+  bool _wasConnected = false;
+  uint8_t _attempt = 0;
 };
@@ -1,46 +1,75 @@
+// Firebase "ts" fields are epoch milliseconds (64-bit)
+#define ARDUINOJSON_USE_LONG_LONG 1
+
 #include <WiFiClientSecure.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include <Arduino.h>
 #include <WiFi.h>
-#include <time.h>
 
 #include "AppConfig.h"
 #include "StatusModel.h"
 #include "LedController.h"
 #include "WifiManager.h"
+#include "ClockService.h"
 #include "WeatherService.h"
 #include "BNO055Sensor.h"
+#include "LiveStreamServer.h"
+#include "WaveformArchive.h"
+#include "EventDetector.h"
+#include "WaveStats.h"
 //#include "TemperatureSensor.h"
 #include "Secret.h"
+#include <esp_system.h>
 
 /**
  * @file BuoyProject.ino
  * @brief Main application coordinator.
  *
+ * Boot is staged so sampling starts right away: LEDs + IMU first, then cached
+ * weather from NVS, then Wi-Fi / SNTP / NWS come up in the background from loop().
+ *
  * Responsibilities:
  *  1) Manage Wi-Fi connectivity and periodic weather refresh (NWS).
- *  2) Synchronize real clock using NTP in Pacific Time (PST/PDT).
+ *  2) Synchronize real clock with non-blocking SNTP; payloads carry epoch-ms "ts".
  *  3) Continuously sample BNO055 motion data through BNO055Sensor module.
  *  4) Read DHT temperature/humidity when a motion window result is ready.
  *  5) Update LED state from wave status (currently wave-only policy).
  *  6) Print telemetry every 10 seconds (throttled logging).
- *  7) Upload latest telemetry to Firebase.
+ *  7) Upload latest telemetry to Firebase (changed fields only, periodic full resync).
  *  8) Append historical logs to Firebase at a lower rate.
+ *  9) Stream full-rate motion samples to LAN clients (LiveStreamServer, own task).
+ * 10) Optionally archive raw 3-axis samples to SD (WaveformArchive, own task).
+ * 11) Capture short motion events and upload each as one burst record.
+ * 12) Track wave heights (H1/3, Hmax) and acceleration p90/p99 per horizon.
  **/
 
 // ---------------- Module instances ----------------
 LedController leds(PIN_LED_RED, PIN_LED_YELLOW, PIN_LED_GREEN);
 WifiManager wifi(WIFI_SSID, WIFI_PASS, WIFI_RETRY_MS);
 WeatherService weather(USER_AGENT, LAT, LON);
+ClockService clockService(TZ_INFO, NTP_SERVER_1, NTP_SERVER_2);
 BNO055Sensor bnoSensor(BNO_ADDR);
+LiveStreamServer liveStream(LIVE_STREAM_PORT, LIVE_STREAM_BATCH, LIVE_STREAM_MAX_LAG_BATCHES);
+WaveformArchive archive(clockService, ARCHIVE_SD_CS_PIN, BNO_SAMPLE_RATE, ARCHIVE_BLOCK_SAMPLES, ARCHIVE_FILE_MAX_BYTES);
+EventDetector eventDetector;
+WaveStats waveStats;
 //TemperatureSensor tempSensor(DHT_PIN, DHT_TYPE);
 
 // ---------------- Shared state ----------------
 WeatherSnapshot ws;
 uint32_t lastWeatherMs = 0;
+bool weatherFetched = false;   // fresh NWS data this boot (ws may hold the NVS copy)
+bool weatherTried = false;
+bool weatherCached = false;    // ws was restored from NVS at boot
+static constexpr uint32_t WEATHER_BOOT_RETRY_MS = 60000; // 1 min: cached-boot fetch delay and retry
 bool motionReady = false;
 
+// Boot timing (millis since reset, 0 = not reached yet)
+uint32_t bootFirstSampleMs = 0;
+uint32_t bootFirstUploadMs = 0;
+bool firstUploadFailed = false;   // an online first upload failed: back to the BNO_PRINT_MS throttle
+
 // Serial/telemetry throttle
 static constexpr uint32_t BNO_PRINT_MS = 10000; // 10 sec
 uint32_t lastBnoPrintMs = 0;
@@ -49,38 +78,30 @@ uint32_t lastBnoPrintMs = 0;
 static constexpr uint32_t LOG_MS = 30000; // 30 sec
 uint32_t lastLogMs = 0;
 
+// Firebase latest full-document resync (between resyncs only deltas are PATCHed)
+static constexpr uint32_t LATEST_RESYNC_MS = 10UL * 60UL * 1000UL; // 10 min
+
+// Event upload retry
+uint32_t lastEventTryMs = 0;
+bool eventTried = false;
+
 // NTP reliability state
 bool lastWifiConnected = false;
+uint32_t wifiUpSinceMs = 0;
 uint32_t lastNtpRetryMs = 0;
 static constexpr uint32_t NTP_RETRY_MS = 30000; // 30 sec retry if unsynced
 
 /**
- * @brief Synchronize ESP32 clock using Pacific Time (PST/PDT).
+ * @brief Live stream service task.
+ *
+ * Runs the LAN server on its own cadence so blocking HTTPS calls in loop() never
+ * hold back readers: only a client whose socket backs up falls behind and gets
+ * frames dropped.
  */
-void syncClockWithNTP() {
-  // Pacific Time with DST rules
-  configTzTime("PST8PDT,M3.2.0/2,M11.1.0/2", "pool.ntp.org", "time.nist.gov");
-
-  time_t nowTs;
-  time(&nowTs);
-
-  int tries = 0;
-  while (nowTs < 100000 && tries < 20) { // wait up to ~10s
-    delay(500);
-    time(&nowTs);
-    tries++;
-  }
-
-  if (nowTs > 100000) {
-    Serial.println("NTP time synced (PST/PDT)");
-    struct tm ti;
-    localtime_r(&nowTs, &ti);
-    char buf[32];
-    strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S %Z", &ti);
-    Serial.print("Local time: ");
-    Serial.println(buf);
-  } else {
-    Serial.println("NTP sync not ready");
+void liveStreamTask(void*) {
+  for (;;) {
+    liveStream.poll(bnoSensor.samples());
+    vTaskDelay(pdMS_TO_TICKS(LIVE_STREAM_POLL_MS));
   }
 }
 
@@ -94,70 +115,267 @@ RiskStatus fuseStatus(RiskStatus a, RiskStatus b) {
 }
 
 /**
- * @brief True if clock appears valid (not epoch/1970).
+ * @brief Records uploaded before the clock synced; their "ts" is patched in afterwards.
+ */
+struct TsFixup {
+  const char* node;   // "logs" or "events" under /buoy
+  char key[32];       // Firebase push id
+  uint32_t tMs;       // millis() the record was taken
+};
+
+static constexpr int TS_FIXUP_MAX = 16;
+static constexpr uint32_t TS_FIXUP_RETRY_MS = 30000; // 30 sec
+TsFixup tsFixups[TS_FIXUP_MAX];
+int tsFixupCount = 0;
+uint32_t lastTsFixupTryMs = 0;
+
+/**
+ * @brief Write "ts" as epoch ms, or null while the clock is unsynced.
  */
-bool isTimeSynced() {
-  time_t nowTs;
-  time(&nowTs);
-  return (nowTs > 1700000000);
+void setTs(JsonDocument& doc, int64_t ts) {
+  if (ts != 0) doc["ts"] = ts; else doc["ts"] = nullptr;
 }
 
 /**
- * @brief Fill output with local time string or "UNSYNCED".
+ * @brief Remember the push id from a POST response so its "ts" can be fixed later.
  */
-void getLocalTimeString(char* out, size_t outSize) {
-  if (!isTimeSynced()) {
-    snprintf(out, outSize, "UNSYNCED");
+void rememberTsFixup(const char* node, const String& resp, uint32_t tMs) {
+  if (tsFixupCount >= TS_FIXUP_MAX) {
+    Serial.println("WARNING: ts fixup queue full; record stays undated.");
     return;
   }
 
-  time_t nowTs;
-  time(&nowTs);
-  struct tm ti;
-  localtime_r(&nowTs, &ti);
-  strftime(out, outSize, "%Y-%m-%d %H:%M:%S %Z", &ti);
+  StaticJsonDocument<128> doc;
+  if (deserializeJson(doc, resp)) return;
+  const char* key = doc["name"] | "";
+  if (key[0] == '\0') return;
+
+  TsFixup& f = tsFixups[tsFixupCount++];
+  f.node = node;
+  strlcpy(f.key, key, sizeof(f.key));
+  f.tMs = tMs;
 }
 
 /**
- * @brief Build date/time strings used in Firebase payload.
+ * @brief Patch "ts" of all queued records in one multi-path PATCH on /buoy.json.
  */
-void buildDateTimeStrings(String& outDate, String& outTime) {
-  if (!isTimeSynced()) {
-    outDate = "UNSYNCED";
-    outTime = "UNSYNCED";
-    return;
+bool flushTsFixups() {
+  if (WiFi.status() != WL_CONNECTED) return false;
+  if (tsFixupCount == 0 || !clockService.isSynced()) return true;
+
+  WiFiClientSecure client;
+  client.setInsecure(); // testing only
+
+  HTTPClient https;
+  String url = String("https://") + FIREBASE_HOST + "/buoy.json";
+
+  if (!https.begin(client, url)) {
+    Serial.println("Firebase ts fixup begin() failed");
+    return false;
   }
 
-  time_t nowTs;
-  time(&nowTs);
-  struct tm ti;
-  localtime_r(&nowTs, &ti);
-
-  char dateBuf[11]; // YYYY-MM-DD
-  char timeBuf[16];  // HH:MM:SS
-  strftime(dateBuf, sizeof(dateBuf), "%Y-%m-%d", &ti);
-  strftime(timeBuf, sizeof(timeBuf), "%I:%M:%S %p", &ti);  // 12-hour + AM/PM
-  if (timeBuf[0] == '0') {
-    memmove(timeBuf, timeBuf + 1, strlen(timeBuf)); // shift left 1 char
+  https.setTimeout(10000);
+  https.addHeader("Content-Type", "application/json");
+
+  StaticJsonDocument<1536> doc;
+  for (int i = 0; i < tsFixupCount; i++) {
+    const TsFixup& f = tsFixups[i];
+    String path = String(f.node) + "/" + f.key + "/ts";
+    doc[path] = clockService.epochMsAt(f.tMs);
   }
 
-  outDate = String(dateBuf);
-  outTime = String(timeBuf);
+  String body;
+  serializeJson(doc, body);
+
+  int code = https.PATCH(body);
+  String resp = https.getString();
+  https.end();
+
+  Serial.printf("Firebase ts fixup PATCH HTTP %d (%d records)\n", code, tsFixupCount);
+  if (code < 200 || code >= 300) {
+    Serial.println("Firebase ts fixup response:");
+    Serial.println(resp);
+    return false;
+  }
+
+  tsFixupCount = 0;
+  return true;
+}
+
+/**
+ * @brief Field values of /buoy/latest as last acknowledged by Firebase.
+ *
+ * Used to send only changed fields (PATCH) instead of the full document.
+ */
+struct LatestFields {
+  int64_t ts = 0;           // epoch ms, 0 = unsynced (sent as null)
+  float tempF = NAN;
+  bool tempValid = false;
+  float humidity = NAN;
+  bool humidityValid = false;
+  float rms = 0.0f;
+  String weatherForecast;
+  int windMph = -1;
+  int gustMph = -1;
+  String windDirection;
+  int64_t weatherTs = 0;    // epoch ms of the NWS fetch, 0 = unknown (sent as null)
+  String buoyStatus;
+  uint32_t statsSeq[WaveStats::MAX_HORIZONS] = {0};   // published summary versions
+  uint32_t bootFirstSampleMs = 0;
+  uint32_t bootFirstUploadMs = 0;
+};
+
+LatestFields latestAcked;
+bool latestAckedValid = false;
+uint32_t lastLatestFullSyncMs = 0;
+
+/**
+ * @brief True if the weather snapshot is older than WEATHER_CACHE_MAX_AGE_S or of unknown age.
+ * While SNTP has not synced yet the age cannot be told, so a dated snapshot counts as fresh.
+ */
+bool weatherStale(const WeatherSnapshot& snap) {
+  if (snap.updatedAtS == 0) return true;
+  int64_t nowMs = clockService.nowEpochMs();
+  if (nowMs == 0) return false;
+  return nowMs / 1000 - (int64_t)snap.updatedAtS > (int64_t)WEATHER_CACHE_MAX_AGE_S;
 }
 
 /**
- * @brief Upload one telemetry snapshot to /buoy/latest.json (overwrite).
+ * @brief True if two optional float fields would serialize to the same value.
  */
-bool uploadLatestToFirebase(const String& dateStr,
-                            const String& timeStr,
+bool sameOptionalFloat(float a, bool aValid, float b, bool bValid) {
+  if (aValid != bValid) return false;
+  return !aValid || a == b;
+}
+
+/**
+ * @brief Short name for the last reset cause (brownout, watchdog, ...).
+ */
+const char* resetReasonString() {
+  switch (esp_reset_reason()) {
+    case ESP_RST_POWERON:   return "POWERON";
+    case ESP_RST_SW:        return "SOFTWARE";
+    case ESP_RST_PANIC:     return "PANIC";
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:       return "WATCHDOG";
+    case ESP_RST_BROWNOUT:  return "BROWNOUT";
+    case ESP_RST_DEEPSLEEP: return "DEEPSLEEP";
+    default:                return "OTHER";
+  }
+}
+
+/**
+ * @brief Firebase key for a stats horizon, e.g. "stats10m".
+ */
+String statsKey(const WaveStatsSummary& st) {
+  return String("stats") + String(st.horizonMs / 60000UL) + "m";
+}
+
+/**
+ * @brief Write one horizon summary as a nested object (NaN -> null).
+ */
+void addStatsObject(JsonObject obj, const WaveStatsSummary& st) {
+  obj["waves"] = st.waves;
+  obj["rejected"] = st.rejected;
+  if (isnan(st.h13))    obj["h13"] = nullptr;    else obj["h13"] = st.h13;
+  if (isnan(st.hmax))   obj["hmax"] = nullptr;   else obj["hmax"] = st.hmax;
+  if (isnan(st.hmean))  obj["hmean"] = nullptr;  else obj["hmean"] = st.hmean;
+  if (isnan(st.accP90)) obj["accP90"] = nullptr; else obj["accP90"] = st.accP90;
+  if (isnan(st.accP99)) obj["accP99"] = nullptr; else obj["accP99"] = st.accP99;
+}
+
+/**
+ * @brief Upload one telemetry snapshot to /buoy/latest.json.
+ *
+ * Only fields that differ from the last acknowledged upload are sent (PATCH).
+ * A full document PUT is sent on the first upload and every LATEST_RESYNC_MS.
+ */
+bool uploadLatestToFirebase(uint32_t sampleMs,
                             float tempF, bool tempValid,
                             float humidity, bool humidityValid,
                             float rms,
                             const WeatherSnapshot & ws,
-                            const String& buoyStatus) {
+                            const String& buoyStatus,
+                            const WaveStats& stats) {
   //Must have Wifi
   if (WiFi.status() != WL_CONNECTED) return false;
 
+  // Current field values
+  LatestFields cur;
+  cur.ts = clockService.epochMsAt(sampleMs);
+  cur.tempF = tempF;
+  cur.tempValid = tempValid;
+  cur.humidity = humidity;
+  cur.humidityValid = humidityValid;
+  cur.rms = rms;
+
+  // Weather fields from NWS
+  cur.weatherForecast = ws.shortForecast;
+  cur.weatherForecast.trim();
+  if (cur.weatherForecast.length() == 0) cur.weatherForecast = "NWS unavailable";
+  cur.windMph = ws.windMph;
+  cur.gustMph = ws.gustMph;
+  cur.windDirection = ws.windDirection;
+  cur.weatherTs = (int64_t)ws.updatedAtS * 1000;
+
+  // wave condition
+  cur.buoyStatus = buoyStatus;
+
+  for (int i = 0; i < stats.horizonCount(); i++) cur.statsSeq[i] = stats.summary(i).seq;
+
+  cur.bootFirstSampleMs = bootFirstSampleMs;
+  cur.bootFirstUploadMs = bootFirstUploadMs;
+
+  bool fullSync = !latestAckedValid || (millis() - lastLatestFullSyncMs >= LATEST_RESYNC_MS);
+  const LatestFields& prev = latestAcked;
+
+  StaticJsonDocument<1024> doc;
+
+  if (fullSync || cur.ts != prev.ts) setTs(doc, cur.ts);
+
+  if (fullSync || !sameOptionalFloat(cur.tempF, cur.tempValid, prev.tempF, prev.tempValid)) {
+    if (cur.tempValid) doc["temperatureF"] = cur.tempF; else doc["temperatureF"] = nullptr;
+  }
+  if (fullSync || !sameOptionalFloat(cur.humidity, cur.humidityValid, prev.humidity, prev.humidityValid)) {
+    if (cur.humidityValid) doc["humidity"] = cur.humidity; else doc["humidity"] = nullptr;
+  }
+
+  //wave metric
+  if (fullSync || cur.rms != prev.rms) doc["rms"] = cur.rms;
+
+  // Slow-changing NWS fields (refreshed every WEATHER_MS)
+  if (fullSync || cur.weatherForecast != prev.weatherForecast) doc["weatherForecast"] = cur.weatherForecast;
+  if (fullSync || cur.windMph != prev.windMph)                 doc["windMph"]         = cur.windMph;
+  if (fullSync || cur.gustMph != prev.gustMph)                 doc["gustMph"]         = cur.gustMph;
+  if (fullSync || cur.windDirection != prev.windDirection)     doc["windDirection"]   = cur.windDirection;
+  if (fullSync || cur.weatherTs != prev.weatherTs) {
+    if (cur.weatherTs) doc["weatherTs"] = cur.weatherTs; else doc["weatherTs"] = nullptr;
+  }
+
+  if (fullSync || cur.buoyStatus != prev.buoyStatus) doc["buoyStatus"] = cur.buoyStatus;
+
+  // Tail statistics only change when a horizon completes
+  for (int i = 0; i < stats.horizonCount(); i++) {
+    const WaveStatsSummary& st = stats.summary(i);
+    if (!st.valid) continue;
+    if (fullSync || cur.statsSeq[i] != prev.statsSeq[i]) {
+      addStatsObject(doc.createNestedObject(statsKey(st)), st);
+    }
+  }
+
+  // Boot timing: sent once per boot, plus when the first-upload time becomes known
+  if (fullSync || cur.bootFirstSampleMs != prev.bootFirstSampleMs ||
+      cur.bootFirstUploadMs != prev.bootFirstUploadMs) {
+    JsonObject boot = doc.createNestedObject("boot");
+    boot["resetReason"] = resetReasonString();
+    if (cur.bootFirstSampleMs) boot["firstSampleMs"] = cur.bootFirstSampleMs; else boot["firstSampleMs"] = nullptr;
+    if (cur.bootFirstUploadMs) boot["firstUploadMs"] = cur.bootFirstUploadMs; else boot["firstUploadMs"] = nullptr;
+  }
+
+  // Nothing changed since the last acknowledged upload
+  if (doc.size() == 0) return true;
+
   WiFiClientSecure client;
   client.setInsecure(); // testing only
 
@@ -173,60 +391,40 @@ bool uploadLatestToFirebase(const String& dateStr,
   https.setTimeout(10000);
   https.addHeader("Content-Type", "application/json");
 
-  StaticJsonDocument<768> doc;
-
-  doc["date"] = dateStr;
-  doc["time"] = timeStr;
-
-
-  if (tempValid) doc["temperatureF"] = tempF; else doc["temperatureF"] = nullptr;
-  if (humidityValid) doc["humidity"] = humidity; else doc["humidity"] = nullptr;
-  
-  //wave metric
-  doc["rms"] = rms;
-
-  // Weather fields from NWS
-  String forecast = ws.shortForecast;
-  forecast.trim();
-  if (forecast.length() == 0) forecast = "NWS unavailable";
- // doc["weatherLabel"]    = ws.shortForecast;     // label shown in UI
-  doc["weatherForecast"] = forecast;     // same string (keep both if you want)
-  
-  //NWS wind fields
-  doc["windMph"]         = ws.windMph;
-  doc["gustMph"]         = ws.gustMph;
-  doc["windDirection"]   = ws.windDirection;
-
-  // wave condition
-  doc["buoyStatus"] = buoyStatus;
-
   String body;
   serializeJson(doc, body);
 
-  int code = https.PUT(body);
+  // PUT replaces the whole document; PATCH only touches the given children
+  int code = fullSync ? https.PUT(body) : https.PATCH(body);
   String resp = https.getString();
   https.end();
 
-  Serial.printf("Firebase latest PUT HTTP %d\n", code);
+  Serial.printf("Firebase latest %s HTTP %d (%u fields, %u bytes)\n",
+                fullSync ? "PUT" : "PATCH", code,
+                (unsigned)doc.size(), (unsigned)body.length());
   if (code < 200 || code >= 300) {
     Serial.println("Firebase latest response:");
     Serial.println(resp);
     return false;
   }
 
+  latestAcked = cur;
+  latestAckedValid = true;
+  if (fullSync) lastLatestFullSyncMs = millis();
+
   return true;
 }
 
 /**
  * @brief Append one telemetry snapshot to /buoy/logs.json (history).
  */
-bool appendLogToFirebase(const String& dateStr,
-                         const String& timeStr,
+bool appendLogToFirebase(uint32_t sampleMs,
                          float tempF, bool tempValid,
                          float humidity, bool humidityValid,
                          float rms,
                          const WeatherSnapshot& ws,
-                         const String& buoyStatus) {
+                         const String& buoyStatus,
+                         const WaveStats& stats) {
   
   //must have wifi
   if (WiFi.status() != WL_CONNECTED) return false;
@@ -245,12 +443,13 @@ bool appendLogToFirebase(const String& dateStr,
   https.setTimeout(10000);
   https.addHeader("Content-Type", "application/json");
 
-  StaticJsonDocument<768> doc;
+  StaticJsonDocument<1024> doc;
 
-  doc["date"] = dateStr;
-  doc["time"] = timeStr;
+  int64_t ts = clockService.epochMsAt(sampleMs);
+  setTs(doc, ts);
 
-  // Must match Firebase rules exactly:
+  // Field set must match the /buoy/logs validation rules (see README "Firebase Data"):
+  // ts (epoch ms, null until the clock syncs; no date/time strings) plus optional statsNm objects
 if (tempValid)    doc["temperatureF"] = tempF;    else doc["temperatureF"] = nullptr;
 if (humidityValid) doc["humidity"]     = humidity; else doc["humidity"]     = nullptr;
   
@@ -272,6 +471,12 @@ if (humidityValid) doc["humidity"]     = humidity; else doc["humidity"]     = nu
   //wave status only
   doc["buoyStatus"] = buoyStatus;
 
+  // Tail statistics of the last completed horizons
+  for (int i = 0; i < stats.horizonCount(); i++) {
+    const WaveStatsSummary& st = stats.summary(i);
+    if (st.valid) addStatsObject(doc.createNestedObject(statsKey(st)), st);
+  }
+
   String body;
   serializeJson(doc, body);
 
@@ -286,72 +491,181 @@ if (humidityValid) doc["humidity"]     = humidity; else doc["humidity"]     = nu
     return false;
   }
 
+  // Taken before the clock synced: date it once time arrives
+  if (ts == 0) rememberTsFixup("logs", resp, sampleMs);
+
+  return true;
+}
+
+/**
+ * @brief Upload one captured motion event to /buoy/events.json (append).
+ *
+ * aVert holds the whole window in 0.01 m/s^2 counts; preSamples is the trigger index.
+ * missedTotal (eventsMissed) tells how many triggers were lost while windows waited.
+ */
+bool uploadEventToFirebase(const CapturedEvent& e, uint32_t missedTotal) {
+  if (WiFi.status() != WL_CONNECTED) return false;
+
+  WiFiClientSecure client;
+  client.setInsecure(); // testing only
+
+  HTTPClient https;
+  String url = String("https://") + FIREBASE_HOST + "/buoy/events.json";
+
+  if (!https.begin(client, url)) {
+    Serial.println("Firebase events begin() failed");
+    return false;
+  }
+
+  https.setTimeout(10000);
+  https.addHeader("Content-Type", "application/json");
+
+  int64_t ts = clockService.epochMsAt(e.triggerMs);
+
+  // Sized for the sample array; one allocation per (rare) event
+  DynamicJsonDocument doc(JSON_ARRAY_SIZE(CapturedEvent::MAX_SAMPLES) + 512);
+
+  setTs(doc, ts);
+  doc["trigger"] = toString(e.trigger);
+  doc["triggerUptimeMs"] = e.triggerMs;
+  doc["sampleRateHz"] = e.sampleRateHz;
+  doc["preSamples"] = e.preSamples;
+  doc["peak"] = e.peakAbs;
+  doc["jerk"] = e.jerkAtTrigger;
+  doc["staLta"] = e.staLtaAtTrigger;
+  doc["gapMs"] = e.gapMs;   // > 0: the window spans a sampling gap
+  doc["missed"] = missedTotal;   // triggers since boot dropped while a window awaited upload
+  doc["scale"] = 1.0f / WAVE_COUNTS_PER_MPS2;
+
+  JsonArray samples = doc.createNestedArray("aVert");
+  for (uint16_t i = 0; i < e.count; i++) samples.add(e.aVert[i]);
+
+  String body;
+  body.reserve(measureJson(doc) + 1);
+  serializeJson(doc, body);
+
+  int code = https.POST(body);
+  String resp = https.getString();
+  https.end();
+
+  Serial.printf("Firebase event POST HTTP %d (%u samples, %u bytes)\n",
+                code, (unsigned)e.count, (unsigned)body.length());
+  if (code < 200 || code >= 300) {
+    Serial.println("Firebase event response:");
+    Serial.println(resp);
+    return false;
+  }
+
+  if (ts == 0) rememberTsFixup("events", resp, e.triggerMs);
+
   return true;
 }
 
 void setup() {
   Serial.begin(115200);
-  delay(300);
+
+  // ---- Stage 1: acquisition (no network, no waits) ----
 
   // 1) LED init
   leds.begin();
   leds.set(RiskStatus::OK);
 
-  // 2) Wi-Fi
-  wifi.begin();
+  // 2) BNO055
+  motionReady = bnoSensor.begin();
+  if (!motionReady) {
+    Serial.println("BNO055 NOT detected");
+    // leds.set(RiskStatus::BAD); // optional if IMU is required
+  } else {
+    Serial.printf("BNO055 detected, sampling from %lu ms\n", (unsigned long)millis());
+  }
 
-  Serial.printf("WiFi.status()=%d\n", (int)WiFi.status());
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.print("RSSI: ");
-    Serial.println(WiFi.RSSI());
+  // 3) Per-sample consumers of the acquisition ring
+  EventDetectorConfig evCfg;
+  evCfg.sampleRateHz = BNO_SAMPLE_RATE;
+  evCfg.preSamples = EVENT_PRE_SAMPLES;
+  evCfg.postSamples = EVENT_POST_SAMPLES;
+  evCfg.absThreshold = EVENT_ABS_THRESHOLD;
+  evCfg.jerkThreshold = EVENT_JERK_THRESHOLD;
+  evCfg.staSeconds = EVENT_STA_S;
+  evCfg.ltaSeconds = EVENT_LTA_S;
+  evCfg.staLtaRatio = EVENT_STA_LTA_RATIO;
+  evCfg.holdoffMs = EVENT_HOLDOFF_MS;
+  eventDetector.begin(evCfg);
+
+  const uint32_t statsHorizons[] = {STATS_SHORT_MS, STATS_LONG_MS};
+  WaveStatsConfig wsCfg;
+  wsCfg.sampleRateHz = BNO_SAMPLE_RATE;
+  wsCfg.minPeriodS = WAVE_MIN_PERIOD_S;
+  wsCfg.maxPeriodS = WAVE_MAX_PERIOD_S;
+  wsCfg.hysteresis = WAVE_HYSTERESIS;
+  wsCfg.maxRange = WAVE_MAX_RANGE;
+  wsCfg.spikeAbs = EVENT_ABS_THRESHOLD;     // an impact for the detector is not a wave here
+  wsCfg.spikeJerk = EVENT_JERK_THRESHOLD;
+  waveStats.begin(statsHorizons, 2, wsCfg);
+
+  // ---- Stage 2: cached state from NVS ----
+
+  // 4) Last hourly URL + weather snapshot (fresh fetch happens in loop)
+  weatherCached = weather.loadCache(ws);
+  if (weatherCached) {
+    Serial.print("Cached weather status: ");
+    Serial.println(toString(ws.weatherStatus));
+    if (ws.updatedAtS == 0) Serial.println("Cached weather has no timestamp; treating it as stale.");
   }
 
-  lastWifiConnected = wifi.isConnected();
+  // ---- Stage 3: connectivity, started but not awaited ----
 
-  // 3) Startup NTP sync
-  if (lastWifiConnected) {
-    syncClockWithNTP();
-  } else {
-    Serial.println("Skipping startup NTP sync (no Wi-Fi).");
-  }
+  // 5) Wi-Fi (connects in the background)
+  wifi.begin();
+  lastWifiConnected = false;
 
-  // 4) Initial weather fetch
-  if (wifi.isConnected()) {
-    if (weather.refresh(ws)) {
-      Serial.print("Initial weather status: ");
-      Serial.println(toString(ws.weatherStatus));
+  // 6) Start SNTP in the background (callback sets the clock when time arrives)
+  clockService.begin();
+  clockService.startSync();
+
+  // 7) Live stream server (LAN, full-rate samples), serviced by its own task
+  if (LIVE_STREAM_ENABLED && motionReady) {
+    bool listening = liveStream.begin();
+    if (listening) {
+      Serial.printf("Live stream listening on TCP port %u\n", (unsigned)LIVE_STREAM_PORT);
     } else {
-      Serial.println("Initial weather fetch failed.");
+      Serial.println("Live stream server failed to start");
+    }
+    bool multicast = LIVE_STREAM_MULTICAST &&
+                     liveStream.enableMulticast(LIVE_STREAM_MCAST_GROUP, LIVE_STREAM_MCAST_PORT);
+    if (LIVE_STREAM_MULTICAST && !multicast) {
+      Serial.println("Live stream multicast failed to start");
+    }
+    if ((listening || multicast) &&
+        xTaskCreatePinnedToCore(liveStreamTask, "live_stream", LIVE_STREAM_TASK_STACK, nullptr,
+                                LIVE_STREAM_TASK_PRIORITY, nullptr, LIVE_STREAM_TASK_CORE) != pdPASS) {
+      Serial.println("Live stream task failed to start");
     }
-  } else {
-    Serial.println("Wi-Fi not connected at boot; weather fetch skipped.");
   }
 
-  // 5) BNO055
-  motionReady = bnoSensor.begin();
-  if (!motionReady) {
-    Serial.println("BNO055 NOT detected");
-    // leds.set(RiskStatus::BAD); // optional if IMU is required
-  } else {
-    Serial.println("BNO055 detected");
+  // 8) Waveform archive (SD), drained by its own task
+  if (ARCHIVE_ENABLED && motionReady && !archive.begin(bnoSensor.samples())) {
+    Serial.println("Waveform archive disabled (no SD)");
   }
 
-  // 6) DHT
+  // DHT
   //tempSensor.begin();
   //Serial.println("DHT ready");
 
-  // 7) Timers
+  // 9) Timers
   uint32_t startMs = millis();
   lastWeatherMs = startMs;
-  lastBnoPrintMs = startMs;
+  lastBnoPrintMs = startMs - BNO_PRINT_MS;   // first window may upload immediately
   lastNtpRetryMs = startMs;
   lastLogMs = startMs;
+
+  Serial.printf("Setup done at %lu ms\n", (unsigned long)startMs);
 }
 
 void loop() {
   uint32_t now = millis();
 
-  // Keep Wi-Fi alive
+  // Keep Wi-Fi alive (non-blocking)
   wifi.ensureConnected();
 
   // NTP re-sync behavior
@@ -359,25 +673,50 @@ void loop() {
 
   // Edge detect: disconnected -> connected
   if (wifiNow && !lastWifiConnected) {
-    Serial.println("Wi-Fi reconnected, syncing NTP...");
-    syncClockWithNTP();
+    wifiUpSinceMs = now;
+    Serial.println("Wi-Fi connected, restarting SNTP...");
+    clockService.startSync();
   }
 
-  // Periodic retry if time still unsynced
-  if (wifiNow && !isTimeSynced() && (now - lastNtpRetryMs >= NTP_RETRY_MS)) {
+  // Periodic retry if time still unsynced (non-blocking)
+  if (wifiNow && !clockService.isSynced() && (now - lastNtpRetryMs >= NTP_RETRY_MS)) {
     lastNtpRetryMs = now;
-    Serial.println("Time unsynced, retrying NTP...");
-    syncClockWithNTP();
+    Serial.println("Time unsynced, restarting SNTP...");
+    clockService.startSync();
   }
 
   lastWifiConnected = wifiNow;
 
-  // Weather refresh
-  if (now - lastWeatherMs >= WEATHER_MS) {
+  if (clockService.takeSyncEvent()) {
+    char timeBuf[40];
+    clockService.formatLocal(timeBuf, sizeof(timeBuf));
+    Serial.print("NTP time synced, local time: ");
+    Serial.println(timeBuf);
+  }
+
+  // Date records that were uploaded while unsynced
+  if (tsFixupCount > 0 && clockService.isSynced() && wifiNow &&
+      now - lastTsFixupTryMs >= TS_FIXUP_RETRY_MS) {
+    lastTsFixupTryMs = now;
+    if (!flushTsFixups()) {
+      Serial.println("WARNING: Firebase ts fixup failed; will retry.");
+    }
+  }
+
+  // Weather refresh: first fetch as soon as Wi-Fi is up, or WEATHER_BOOT_RETRY_MS after it
+  // came up when a fresh cached snapshot already fills the payload; then every WEATHER_MS
+  bool cacheUsable = weatherCached && !weatherStale(ws);
+  bool weatherDue = weatherFetched
+    ? (now - lastWeatherMs >= WEATHER_MS)
+    : (wifiNow && (!cacheUsable || now - wifiUpSinceMs >= WEATHER_BOOT_RETRY_MS) &&
+       (!weatherTried || now - lastWeatherMs >= WEATHER_BOOT_RETRY_MS));
+  if (weatherDue) {
     lastWeatherMs = now;
+    weatherTried = true;
 
-    if (wifi.isConnected()) {
+    if (wifiNow) {
       if (weather.refresh(ws)) {
+        weatherFetched = true;
         Serial.print("Weather status: ");
         Serial.println(toString(ws.weatherStatus));
       } else {
@@ -388,9 +727,37 @@ void loop() {
     }
   }
 
-  // Motion sampling / window processing
+  // Motion consumers / window processing (sampling itself runs in the BNO task)
   if (motionReady) {
-    bnoSensor.update();
+    if (bootFirstSampleMs == 0 && bnoSensor.samples().headSeq() > 0) {
+      MotionSample first;
+      bnoSensor.samples().read(bnoSensor.samples().oldestSeq(), first);
+      bootFirstSampleMs = first.tMs;
+      Serial.printf("Boot: first sample at %lu ms (reset: %s)\n",
+                    (unsigned long)bootFirstSampleMs, resetReasonString());
+    }
+
+    // Wave-by-wave heights and acceleration quantiles
+    waveStats.poll(bnoSensor.samples());
+
+    // Event detection on every sample; frozen windows are uploaded as one record
+    eventDetector.poll(bnoSensor.samples());
+    if (eventDetector.hasEvent() && wifi.isConnected() &&
+        (!eventTried || now - lastEventTryMs >= EVENT_RETRY_MS)) {
+      const CapturedEvent& e = eventDetector.event();
+      Serial.printf("Event %s: peak=%.2f m/s^2 staLta=%.1f jerk=%.0f (missed so far: %lu)\n",
+                    toString(e.trigger), e.peakAbs, e.staLtaAtTrigger, e.jerkAtTrigger,
+                    (unsigned long)eventDetector.eventsMissed());
+
+      lastEventTryMs = now;
+      eventTried = true;
+      if (uploadEventToFirebase(e, eventDetector.eventsMissed())) {
+        eventDetector.release();
+        eventTried = false;
+      } else {
+        Serial.println("WARNING: Firebase event upload failed; will retry.");
+      }
+    }
 
     if (bnoSensor.hasWindowResult()) {
       BNO055SensorReading m = bnoSensor.takeWindowResult();
@@ -407,13 +774,17 @@ void loop() {
       weatherLabel.trim();
       if (weatherLabel.length() == 0) weatherLabel = "NWS unavailable";
 
-      // Throttled print + upload
-      if (now - lastBnoPrintMs >= BNO_PRINT_MS) {
+      // Throttled print + upload (the first upload of this boot goes out on the first
+      // window with Wi-Fi; if that HTTP attempt fails, retries fall back to the
+      // BNO_PRINT_MS throttle). Windows without Wi-Fi never use up the first attempt.
+      bool wifiUp = wifi.isConnected();
+      bool firstUploadPending = (bootFirstUploadMs == 0 && !firstUploadFailed && wifiUp);
+      if (now - lastBnoPrintMs >= BNO_PRINT_MS || firstUploadPending) {
         lastBnoPrintMs = now;
 
         // Serial print
         char timeBuf[40];
-        getLocalTimeString(timeBuf, sizeof(timeBuf));
+        clockService.formatLocal(timeBuf, sizeof(timeBuf));
         Serial.print("Time=");
         Serial.print(timeBuf);
 
@@ -451,23 +822,43 @@ void loop() {
         Serial.print("s  Crossings=");
         Serial.println(m.crossings);
 
+        for (int i = 0; i < waveStats.horizonCount(); i++) {
+          const WaveStatsSummary& st = waveStats.summary(i);
+          if (!st.valid) continue;
+          Serial.printf("Stats %s: waves=%lu H1/3=%.2fm Hmax=%.2fm p90=%.3f p99=%.3f\n",
+                        statsKey(st).c_str(), (unsigned long)st.waves,
+                        st.h13, st.hmax, st.accP90, st.accP99);
+        }
+
+        if (archive.isReady() && archive.storedBytes() > 0) {
+          Serial.printf("Archive: blocks=%lu ratio=%.2f dropped=%lu\n",
+                        (unsigned long)archive.blocksWritten(),
+                        (float)archive.rawBytes() / (float)archive.storedBytes(),
+                        (unsigned long)archive.samplesDropped());
+        }
+
         // Build payload fields
         String buoyStatus = String(toString(finalStatus));
-        String dateStr, timeStr;
-        buildDateTimeStrings(dateStr, timeStr);
 
         // Always update latest snapshot
-        bool upOk = uploadLatestToFirebase(
-          dateStr,
-          timeStr,
+        bool upOk = wifiUp && uploadLatestToFirebase(
+          now,
           ws.temperatureF, ws.temperatureValid,
           ws.humidity, ws.humidityValid,
           m.rms,
           ws,
-          buoyStatus
+          buoyStatus,
+          waveStats
         );
-        if (!upOk) {
+        if (!wifiUp) {
+          Serial.println("Skipping Firebase upload (no Wi-Fi).");
+        } else if (!upOk) {
           Serial.println("WARNING: Firebase latest upload failed.");
+          if (bootFirstUploadMs == 0) firstUploadFailed = true;
+        } else if (bootFirstUploadMs == 0) {
+          bootFirstUploadMs = millis();
+          Serial.printf("Boot: first upload at %lu ms (first sample at %lu ms)\n",
+                        (unsigned long)bootFirstUploadMs, (unsigned long)bootFirstSampleMs);
         }
 
         // Append history at lower rate
@@ -475,13 +866,13 @@ void loop() {
           lastLogMs = now;
 
           bool logOk = appendLogToFirebase(
-            dateStr,
-            timeStr,
+            now,
             ws.temperatureF, ws.temperatureValid,
             ws.humidity, ws.humidityValid,
             m.rms,
             ws,
-            buoyStatus
+            buoyStatus,
+            waveStats
           );
           if (!logOk) {
             Serial.println("WARNING: Firebase log append failed.");
@@ -0,0 +1,273 @@
+/**
+ * @file live_stream_client.cpp
+ * @brief Host client and loopback self-test for the buoy's live motion stream.
+ *
+ * Build:  g++ -O2 -std=c++17 -I../buoy_monitor live_stream_client.cpp ../buoy_monitor/LiveStreamServer.cpp ../buoy_monitor/MotionRing.cpp -o live_stream_client
+ * Usage:  ./live_stream_client <buoy-ip> [port=5055]   # print samples as CSV
+ *         ./live_stream_client --loopback             # self-test, exit code 0 = pass
+ *
+ * Client mode connects to LiveStreamServer over TCP, decodes "BYLS" frames and prints
+ * "seq,t_ms,ax,ay,az,a_vert,a_lp". Gaps (seq jumps / dropped counter) go to stderr.
+ *
+ * Loopback mode runs the firmware server in-process on 127.0.0.1 and checks:
+ * frame layout and contiguous seqs, skip-ahead of a client that stops reading
+ * (seq jump == dropped counter delta), that a closed client is reaped and that the
+ * multicast reader starts at the live edge.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "LiveStreamServer.h"
+
+static uint16_t rd16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t rd32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static float rdF(const uint8_t* p) {
+  uint32_t u = rd32(p);
+  float f;
+  memcpy(&f, &u, 4);
+  return f;
+}
+
+struct Frame {
+  uint16_t version = 0;
+  uint32_t firstSeq = 0;
+  uint32_t dropped = 0;
+  std::vector<MotionSample> samples;
+};
+
+// Reassembles frames from a TCP byte stream
+class FrameReader {
+public:
+  void feed(const uint8_t* data, size_t len) { _buf.insert(_buf.end(), data, data + len); }
+
+  // 1 = frame decoded, 0 = need more bytes, -1 = stream is not a BYLS stream
+  int next(Frame& f) {
+    if (_buf.size() < LiveStreamServer::HEADER_BYTES) return 0;
+    if (memcmp(_buf.data(), "BYLS", 4) != 0) return -1;
+    uint16_t count = rd16(&_buf[6]);
+    if (count > LiveStreamServer::MAX_BATCH) return -1;
+    size_t len = LiveStreamServer::HEADER_BYTES + count * LiveStreamServer::SAMPLE_BYTES;
+    if (_buf.size() < len) return 0;
+
+    f.version = rd16(&_buf[4]);
+    f.firstSeq = rd32(&_buf[8]);
+    f.dropped = rd32(&_buf[12]);
+    f.samples.resize(count);
+    const uint8_t* p = &_buf[LiveStreamServer::HEADER_BYTES];
+    for (uint16_t i = 0; i < count; i++, p += LiveStreamServer::SAMPLE_BYTES) {
+      MotionSample& s = f.samples[i];
+      s.tMs = rd32(p);
+      s.ax = rdF(p + 4);
+      s.ay = rdF(p + 8);
+      s.az = rdF(p + 12);
+      s.aVert = rdF(p + 16);
+      s.aLP = rdF(p + 20);
+    }
+    _buf.erase(_buf.begin(), _buf.begin() + len);
+    return 1;
+  }
+
+private:
+  std::vector<uint8_t> _buf;
+};
+
+static int connectTo(const char* ip, uint16_t port, int rcvBuf = 0) {
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (inet_pton(AF_INET, ip, &addr.sin_addr) != 1) return -1;
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  if (rcvBuf > 0) setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvBuf, sizeof(rcvBuf));
+  if (connect(fd, (const sockaddr*)&addr, sizeof(addr)) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static int runClient(const char* ip, uint16_t port) {
+  int fd = connectTo(ip, port);
+  if (fd < 0) {
+    fprintf(stderr, "cannot connect to %s:%u\n", ip, (unsigned)port);
+    return 1;
+  }
+
+  printf("seq,t_ms,ax,ay,az,a_vert,a_lp\n");
+  FrameReader reader;
+  Frame f;
+  bool haveSeq = false;
+  uint32_t expectSeq = 0;
+  uint8_t buf[4096];
+
+  for (;;) {
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0) break;
+    reader.feed(buf, (size_t)n);
+
+    int r;
+    while ((r = reader.next(f)) == 1) {
+      if (haveSeq && f.firstSeq != expectSeq) {
+        fprintf(stderr, "gap: %u samples skipped (dropped total %u)\n",
+                (unsigned)(f.firstSeq - expectSeq), (unsigned)f.dropped);
+      }
+      for (size_t i = 0; i < f.samples.size(); i++) {
+        const MotionSample& s = f.samples[i];
+        printf("%u,%u,%.4f,%.4f,%.4f,%.4f,%.4f\n", (unsigned)(f.firstSeq + i), (unsigned)s.tMs,
+               s.ax, s.ay, s.az, s.aVert, s.aLP);
+      }
+      expectSeq = f.firstSeq + (uint32_t)f.samples.size();
+      haveSeq = true;
+    }
+    if (r < 0) {
+      fprintf(stderr, "bad frame, not a live stream?\n");
+      break;
+    }
+  }
+
+  close(fd);
+  return 0;
+}
+
+// ---------------- Loopback self-test ----------------
+
+static int g_failures = 0;
+
+static void check(bool ok, const char* what) {
+  printf("%s  %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok) g_failures++;
+}
+
+static MotionSample makeSample(uint32_t seq) {
+  MotionSample s;
+  s.tMs = seq * 20;
+  s.ax = (float)seq;
+  s.ay = -(float)seq;
+  s.az = 9.81f;
+  s.aVert = 0.5f;
+  s.aLP = (float)(seq % 100);
+  return s;
+}
+
+// Read whatever the server has sent so far into reader
+static void drain(int fd, FrameReader& reader) {
+  uint8_t buf[4096];
+  for (;;) {
+    ssize_t n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+    if (n <= 0) return;
+    reader.feed(buf, (size_t)n);
+  }
+}
+
+static int runLoopback() {
+  const uint16_t port = 15055;
+  const uint16_t batch = 10;
+  static MotionSample storage[512];
+  MotionRing ring(storage, 512);
+  LiveStreamServer server(port, batch, 4);
+  if (!server.begin()) {
+    fprintf(stderr, "cannot listen on %u\n", (unsigned)port);
+    return 1;
+  }
+
+  // Small receive buffer so a reader that stops reading backs up quickly
+  int fd = connectTo("127.0.0.1", port, 4096);
+  check(fd >= 0, "client connects");
+  if (fd < 0) return 1;
+  usleep(20000);
+  server.poll(ring);
+  check(server.clientCount() == 1, "server accepts the client");
+
+  // 1) Contiguous frames while the client keeps up
+  uint32_t seq = 0;
+  for (int i = 0; i < 35; i++) {
+    ring.push(makeSample(seq++));
+    server.poll(ring);
+  }
+  usleep(20000);
+
+  FrameReader reader;
+  drain(fd, reader);
+  Frame f;
+  int frames = 0;
+  bool layoutOk = true;
+  uint32_t expect = 0;
+  while (reader.next(f) == 1) {
+    layoutOk = layoutOk && f.version == 1 && f.samples.size() == batch && f.firstSeq == expect &&
+               f.dropped == 0;
+    for (size_t i = 0; i < f.samples.size(); i++) {
+      MotionSample want = makeSample(f.firstSeq + (uint32_t)i);
+      layoutOk = layoutOk && memcmp(&f.samples[i], &want, sizeof(want)) == 0;
+    }
+    expect = f.firstSeq + batch;
+    frames++;
+  }
+  check(frames == 3, "3 full batches for 35 samples");
+  check(layoutOk, "frame header, seqs and sample payload match");
+
+  // 2) Client stops reading: the server must skip it ahead instead of buffering
+  for (int i = 0; i < 1000000; i++) {
+    ring.push(makeSample(seq++));
+    server.poll(ring);
+  }
+  check(server.samplesDropped() > 0, "stalled client is skipped ahead");
+
+  drain(fd, reader);
+  bool jumpsMatch = true;
+  bool sawJump = false;
+  uint32_t lastDropped = 0;
+  while (reader.next(f) == 1) {
+    if (f.firstSeq != expect) {
+      sawJump = true;
+      jumpsMatch = jumpsMatch && (f.firstSeq - expect) == (f.dropped - lastDropped);
+    }
+    expect = f.firstSeq + (uint32_t)f.samples.size();
+    lastDropped = f.dropped;
+  }
+  check(sawJump && jumpsMatch, "seq jumps equal the dropped counter delta");
+
+  // 3) Hang-up is noticed without blocking
+  close(fd);
+  usleep(20000);
+  server.poll(ring);
+  check(server.clientCount() == 0, "closed client is reaped");
+
+  // 4) Multicast reader starts at the live edge (no backlog counted as dropped)
+  if (server.enableMulticast("239.10.0.55", port + 1)) {
+    uint32_t sentBefore = server.framesSent();
+    uint32_t droppedBefore = server.samplesDropped();
+    for (int i = 0; i < 30; i++) {
+      ring.push(makeSample(seq++));
+      server.poll(ring);
+    }
+    if (server.framesSent() > sentBefore) {
+      check(server.samplesDropped() == droppedBefore, "multicast starts at the ring head");
+    } else {
+      printf("skip  multicast (no route to the group on this host)\n");
+    }
+  }
+
+  server.stop();
+  printf("%s (%d failure%s)\n", g_failures ? "FAILED" : "PASSED", g_failures, g_failures == 1 ? "" : "s");
+  return g_failures ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1 && strcmp(argv[1], "--loopback") == 0) return runLoopback();
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <buoy-ip> [port] | --loopback\n", argv[0]);
+    return 2;
+  }
+  uint16_t port = (argc > 2) ? (uint16_t)atoi(argv[2]) : 5055;
+  return runClient(argv[1], port);
+}
@@ -0,0 +1,196 @@
+/**
+ * @file motion_selftest.cpp
+ * @brief Host self-test for the per-sample motion consumers (WaveStats, EventDetector).
+ *
+ * Build:  g++ -O2 -std=c++17 -I../buoy_monitor motion_selftest.cpp ../buoy_monitor/WaveStats.cpp ../buoy_monitor/EventDetector.cpp ../buoy_monitor/MotionRing.cpp ../buoy_monitor/WaveformCodec.cpp -o motion_selftest
+ * Usage:  ./motion_selftest          # exit code 0 = pass
+ *
+ * Feeds synthetic 50 Hz motion through a MotionRing, the same way the firmware does,
+ * and checks:
+ *  - a 2 m / 8 s swell gives H1/3 and Hmax of ~2 m;
+ *  - an impact slam inside that swell is rejected instead of inflating Hmax;
+ *  - sampling gaps do not inflate heights or fire false JERK events;
+ *  - a spike fires one THRESHOLD capture with the full pre-trigger window;
+ *  - a gap re-warms STA/LTA, and a gap inside a capture is recorded in gapMs.
+ */
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include "EventDetector.h"
+#include "WaveStats.h"
+
+static const uint16_t RATE_HZ = 50;
+static const uint32_t DT_MS = 1000 / RATE_HZ;
+
+static int g_failures = 0;
+
+static void check(bool ok, const char* what) {
+  printf("%s  %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok) g_failures++;
+}
+
+static bool near(float v, float want, float tol) { return fabsf(v - want) <= tol; }
+
+// Vertical acceleration of a sinusoidal swell with height heightM (crest to trough)
+static float swellAccel(uint32_t tMs, float heightM, float periodS) {
+  float w = 2.0f * (float)M_PI / periodS;
+  return -(heightM / 2.0f) * w * w * sinf(w * tMs / 1000.0f);
+}
+
+static MotionSample sampleAt(uint32_t tMs, float aVert) {
+  MotionSample s;
+  s.tMs = tMs;
+  s.az = 9.81f + aVert;
+  s.aVert = aVert;
+  s.aLP = aVert;
+  return s;
+}
+
+// ---------------- WaveStats ----------------
+
+struct StatsRun {
+  static constexpr uint32_t RING = 1024;
+  MotionSample storage[RING];
+  MotionRing ring{storage, RING};
+  WaveStats stats;
+
+  StatsRun() {
+    const uint32_t horizon[] = {60UL * 60UL * 1000UL};
+    WaveStatsConfig cfg;
+    cfg.sampleRateHz = RATE_HZ;
+    stats.begin(horizon, 1, cfg);
+  }
+
+  void push(const MotionSample& s) {
+    ring.push(s);
+    stats.poll(ring);
+  }
+};
+
+// One hour of 2 m / 8 s swell (+ a bit past the horizon so it publishes)
+static void testSwell(int slamAt, uint32_t stallEvery, const char* what, bool expectRejected) {
+  std::unique_ptr<StatsRun> owner(new StatsRun());   // ring storage is too big for the stack
+  StatsRun& run = *owner;
+
+  uint32_t t = 0;
+  for (uint32_t i = 0; i < RATE_HZ * 3600UL + 100; i++) {
+    if (stallEvery && i % stallEvery == stallEvery - 1) t += 4000;
+    t += DT_MS;
+    MotionSample s = sampleAt(t, swellAccel(t, 2.0f, 8.0f));
+    if ((int)i == slamAt) {
+      s.aVert = 20.0f;                                  // slam on the raw signal
+      s.aLP = 0.25f * s.aVert + 0.75f * s.aLP;          // what the low-pass lets through
+    }
+    run.push(s);
+  }
+
+  const WaveStatsSummary& st = run.stats.summary(0);
+  char msg[128];
+  snprintf(msg, sizeof(msg), "%s: H1/3=%.2f Hmax=%.2f waves=%u rejected=%u", what,
+           st.h13, st.hmax, (unsigned)st.waves, (unsigned)st.rejected);
+  check(st.valid && near(st.h13, 2.0f, 0.1f) && near(st.hmax, 2.0f, 0.15f) &&
+        (st.rejected > 0) == expectRejected, msg);
+}
+
+// ---------------- EventDetector ----------------
+
+struct EventRun {
+  static constexpr uint32_t RING = 1024;
+  MotionSample storage[RING];
+  MotionRing ring{storage, RING};
+  EventDetector detector;
+  int events = 0;
+  CapturedEvent last;
+
+  EventRun() {
+    EventDetectorConfig cfg;
+    cfg.sampleRateHz = RATE_HZ;
+    detector.begin(cfg);
+  }
+
+  void push(const MotionSample& s) {
+    ring.push(s);
+    detector.poll(ring);
+    if (detector.hasEvent()) {
+      last = detector.event();
+      events++;
+      detector.release();
+    }
+  }
+};
+
+static void testSpikeCapture() {
+  std::unique_ptr<EventRun> owner(new EventRun());
+  EventRun& run = *owner;
+
+  // 60 s calm (past LTA warm-up), one 20 m/s^2 spike, then 10 s calm
+  uint32_t spikeAt = 60 * RATE_HZ;
+  for (uint32_t i = 0; i < 70 * RATE_HZ; i++) {
+    uint32_t t = (i + 1) * DT_MS;
+    float a = (i == spikeAt) ? 20.0f : 0.1f * sinf(i * 0.3f);
+    run.push(sampleAt(t, a));
+  }
+
+  const CapturedEvent& e = run.last;
+  check(run.events == 1 && e.trigger == EventTrigger::THRESHOLD, "spike fires one THRESHOLD capture");
+  check(e.preSamples == 150 && e.count == 150 + 1 + 250, "capture holds 150 pre + trigger + 250 post");
+  check(e.aVert[e.preSamples] == 2000 && e.gapMs == 0, "trigger sample at preSamples, no gap");
+}
+
+static void testGapsNoFalseJerk() {
+  std::unique_ptr<EventRun> owner(new EventRun());
+  EventRun& run = *owner;
+
+  // Swell whose level jumps across 3 s gaps: jerk across a gap would be huge
+  uint32_t t = 0;
+  for (uint32_t i = 0; i < 8000; i++) {
+    if (i % 1000 == 999) t += 3000;
+    t += DT_MS;
+    run.push(sampleAt(t, swellAccel(t, 6.0f, 8.0f)));
+  }
+  check(run.events == 0, "gaps in a swell fire no JERK events");
+}
+
+// Calm water, then a sudden 2 m/s^2 oscillation (well below abs/jerk thresholds):
+// STA/LTA fires on the step, unless a gap right before it restarted the warm-up.
+static int staLtaEvents(bool gapBeforeStep) {
+  std::unique_ptr<EventRun> owner(new EventRun());
+  EventRun& run = *owner;
+
+  uint32_t t = 0;
+  for (uint32_t i = 0; i < 90 * RATE_HZ; i++) {
+    if (gapBeforeStep && i == 60 * RATE_HZ) t += 2000;
+    t += DT_MS;
+    float a = (i < 60 * RATE_HZ) ? 0.05f * sinf(i * 0.3f) : 2.0f * sinf(2.0f * (float)M_PI * t / 1000.0f);
+    run.push(sampleAt(t, a));
+  }
+  return (run.events > 0 && run.last.trigger == EventTrigger::STA_LTA) ? 1 : 0;
+}
+
+static void testGapInCapture() {
+  std::unique_ptr<EventRun> owner(new EventRun());
+  EventRun& run = *owner;
+
+  uint32_t t = 0;
+  for (uint32_t i = 0; i < 70 * RATE_HZ; i++) {
+    if (i == 60 * RATE_HZ + 100) t += 1000;   // stall 100 samples after the trigger
+    t += DT_MS;
+    run.push(sampleAt(t, (i == 60 * RATE_HZ) ? 20.0f : 0.1f));
+  }
+  check(run.events == 1 && run.last.gapMs >= 1000 - DT_MS, "gap inside a capture is recorded in gapMs");
+}
+
+int main() {
+  testSwell(-1, 0, "2 m / 8 s swell", false);
+  testSwell(100000, 0, "swell + 20 m/s^2 slam", true);
+  testSwell(-1, 5000, "swell + 4 s gaps", false);
+
+  testSpikeCapture();
+  testGapsNoFalseJerk();
+  check(staLtaEvents(false) == 1, "energy step fires STA_LTA");
+  check(staLtaEvents(true) == 0, "gap before the step re-warms STA/LTA");
+  testGapInCapture();
+
+  printf("%s (%d failure%s)\n", g_failures ? "FAILED" : "PASSED", g_failures, g_failures == 1 ? "" : "s");
+  return g_failures ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file wave_bench.cpp
+ * @brief Throughput / compression-ratio benchmark for the waveform archive codec.
+ *
+ * Build:  g++ -O2 -std=c++17 -I../buoy_monitor wave_bench.cpp ../buoy_monitor/WaveformCodec.cpp -o wave_bench
+ * Usage:  ./wave_bench [rateHz=100] [minutes=60]
+ *
+ * Synthesizes buoy-like motion (gravity on Z, swell + chop + sensor noise), encodes it
+ * in archive blocks, verifies a lossless round trip and reports MB/s, ratio and the
+ * projected SD usage per week at the given rate.
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "WaveformCodec.h"
+
+int main(int argc, char** argv) {
+  int rateHz = (argc > 1) ? atoi(argv[1]) : 100;
+  int minutes = (argc > 2) ? atoi(argv[2]) : 60;
+  if (rateHz <= 0 || minutes <= 0) return 2;
+
+  const size_t n = (size_t)rateHz * 60 * minutes;
+  std::vector<int16_t> xyz(n * 3);
+
+  std::mt19937 rng(55);
+  std::normal_distribution<float> noise(0.0f, 0.03f);  // ~BNO055 accel noise (m/s^2)
+  for (size_t i = 0; i < n; i++) {
+    float t = (float)i / rateHz;
+    float swell = 1.2f * sinf(2.0f * (float)M_PI * t / 9.0f);
+    float chop = 0.4f * sinf(2.0f * (float)M_PI * t / 2.3f + 1.0f);
+    float tiltX = 0.8f * sinf(2.0f * (float)M_PI * t / 6.0f);
+    float tiltY = 0.6f * sinf(2.0f * (float)M_PI * t / 7.5f + 0.5f);
+    xyz[i * 3 + 0] = waveQuantize(tiltX + noise(rng));
+    xyz[i * 3 + 1] = waveQuantize(tiltY + noise(rng));
+    xyz[i * 3 + 2] = waveQuantize(9.81f + swell + chop + noise(rng));
+  }
+
+  std::vector<uint8_t> archive;
+  archive.reserve(n * 6);
+  uint8_t block[WAVE_BLOCK_MAX_BYTES];
+
+  // Encode
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n; i += WAVE_BLOCK_MAX_SAMPLES) {
+    uint16_t cnt = (uint16_t)((n - i) < WAVE_BLOCK_MAX_SAMPLES ? (n - i) : WAVE_BLOCK_MAX_SAMPLES);
+    size_t len = waveEncodeBlock(&xyz[i * 3], cnt, (uint16_t)rateHz,
+                                 (uint32_t)(i * 1000 / rateHz),
+                                 (uint32_t)((i + cnt - 1) * 1000 / rateHz), 0, block, sizeof(block));
+    if (len == 0) { fprintf(stderr, "encode failed\n"); return 1; }
+    archive.insert(archive.end(), block, block + len);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  // Decode + verify
+  std::vector<int16_t> back(n * 3);
+  size_t pos = 0, outIdx = 0;
+  while (pos < archive.size()) {
+    WaveBlockInfo info;
+    size_t len = waveParseHeader(&archive[pos], archive.size() - pos, info);
+    if (len == 0 || !waveDecodeBlock(&archive[pos], len, info, &back[outIdx * 3], WAVE_BLOCK_MAX_SAMPLES)) {
+      fprintf(stderr, "decode failed at byte %zu\n", pos);
+      return 1;
+    }
+    outIdx += info.sampleCount;
+    pos += len;
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  if (outIdx != n || back != xyz) {
+    fprintf(stderr, "round trip mismatch\n");
+    return 1;
+  }
+
+  double encS = std::chrono::duration<double>(t1 - t0).count();
+  double decS = std::chrono::duration<double>(t2 - t1).count();
+  double rawBytes = n * 6.0;
+  double ratio = rawBytes / archive.size();
+  double bytesPerSec = archive.size() / (60.0 * minutes);
+
+  printf("samples        : %zu (%d Hz, %d min)\n", n, rateHz, minutes);
+  printf("raw int16 xyz  : %.0f bytes\n", rawBytes);
+  printf("archived       : %zu bytes (%.2f bits/sample/axis)\n",
+         archive.size(), archive.size() * 8.0 / (n * 3.0));
+  printf("ratio          : %.2fx vs int16, %.2fx vs float32\n", ratio, ratio * 2.0);
+  printf("encode         : %.1f MB/s raw (%.0fx real time)\n",
+         rawBytes / encS / 1e6, (n / (double)rateHz) / encS);
+  printf("decode         : %.1f MB/s raw\n", rawBytes / decS / 1e6);
+  printf("SD usage       : %.1f MB/day, %.1f MB/week\n",
+         bytesPerSec * 86400 / 1e6, bytesPerSec * 86400 * 7 / 1e6);
+  return 0;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file wave_decode.cpp
+ * @brief Host-side decoder for buoy waveform archive files (/wave/NNNNNN.bwa).
+ *
+ * Build:  g++ -O2 -std=c++17 -I../buoy_monitor wave_decode.cpp ../buoy_monitor/WaveformCodec.cpp -o wave_decode
+ * Usage:  ./wave_decode 000001.bwa [more.bwa ...] > samples.csv
+ *
+ * Prints CSV: block,t_ms,epoch_ms,ax,ay,az (m/s^2). Pass the files of one deployment
+ * in order. Blocks written before the buoy clock synced are dated from the first time
+ * anchor of the same boot; epoch_ms stays empty if that boot never synced. The buoy
+ * opens a new file every boot, so boots only change at a file boundary: a file whose
+ * first block is older (t_ms) than the last data block before it starts a new boot.
+ * Inside a file a time anchor may precede the in-progress block it dates; that is
+ * not a boot. Corrupt blocks (bad CRC) are skipped by scanning
+ * for the next block magic; a summary goes to stderr.
+ */
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "WaveformCodec.h"
+
+static bool readFile(const char* path, std::vector<uint8_t>& out) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  uint8_t buf[65536];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.insert(out.end(), buf, buf + n);
+  fclose(f);
+  return true;
+}
+
+struct BlockRef {
+  size_t file;
+  size_t pos;
+  size_t len;
+  WaveBlockInfo info;
+  int boot;
+};
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s file.bwa [...]\n", argv[0]);
+    return 2;
+  }
+
+  unsigned long blocks = 0, samples = 0, badBlocks = 0;
+  unsigned long long storedBytes = 0;
+
+  // 1) Index every valid block across all files, split into boots
+  std::vector<std::vector<uint8_t>> files(argc - 1);
+  std::vector<BlockRef> refs;
+  int boot = 0;
+  bool haveLastDataMs = false;
+  uint32_t lastDataMs = 0;
+
+  for (int fi = 1; fi < argc; fi++) {
+    std::vector<uint8_t>& data = files[fi - 1];
+    if (!readFile(argv[fi], data)) {
+      fprintf(stderr, "cannot read %s\n", argv[fi]);
+      return 1;
+    }
+
+    size_t pos = 0;
+    bool firstInFile = true;
+    while (pos + WAVE_BLOCK_HEADER_BYTES <= data.size()) {
+      WaveBlockInfo info;
+      size_t len = waveParseHeader(&data[pos], data.size() - pos, info);
+      if (len == 0 || pos + len > data.size() || !waveCheckCrc(&data[pos], len)) {
+        // Resync on the next magic
+        badBlocks++;
+        size_t next = pos + 1;
+        while (next + 4 <= data.size() && memcmp(&data[next], "BYWA", 4) != 0) next++;
+        pos = next;
+        continue;
+      }
+
+      if (firstInFile && haveLastDataMs && info.startMs < lastDataMs) boot++;
+      firstInFile = false;
+      if (info.type == WAVE_BLOCK_TYPE_DATA) {
+        haveLastDataMs = true;
+        lastDataMs = info.startMs;
+      }
+
+      refs.push_back({(size_t)(fi - 1), pos, len, info, boot});
+      pos += len;
+    }
+  }
+
+  // 2) First time anchor of each boot
+  std::vector<const WaveBlockInfo*> anchor(boot + 1, nullptr);
+  for (const BlockRef& r : refs) {
+    if (r.info.type == WAVE_BLOCK_TYPE_TIME && r.info.startEpochMs != 0 && !anchor[r.boot]) {
+      anchor[r.boot] = &r.info;
+    }
+  }
+
+  // 3) Decode data blocks
+  printf("block,t_ms,epoch_ms,ax,ay,az\n");
+  int16_t xyz[WAVE_BLOCK_MAX_SAMPLES * 3];
+
+  for (const BlockRef& r : refs) {
+    if (r.info.type != WAVE_BLOCK_TYPE_DATA) continue;
+
+    WaveBlockInfo info;
+    if (!waveDecodeBlock(&files[r.file][r.pos], r.len, info, xyz, WAVE_BLOCK_MAX_SAMPLES)) {
+      badBlocks++;
+      continue;
+    }
+
+    int64_t epoch0 = info.startEpochMs;
+    const WaveBlockInfo* a = anchor[r.boot];
+    if (epoch0 == 0 && a) epoch0 = a->startEpochMs + (int32_t)(info.startMs - a->startMs);
+
+    for (uint16_t i = 0; i < info.sampleCount; i++) {
+      double offMs = waveSampleOffsetMs(info, i);
+      printf("%lu,%.0f,", blocks, info.startMs + offMs);
+      if (epoch0 != 0) printf("%.0f", (double)epoch0 + offMs);
+      printf(",%.2f,%.2f,%.2f\n",
+             xyz[i * 3 + 0] / WAVE_COUNTS_PER_MPS2,
+             xyz[i * 3 + 1] / WAVE_COUNTS_PER_MPS2,
+             xyz[i * 3 + 2] / WAVE_COUNTS_PER_MPS2);
+    }
+
+    blocks++;
+    samples += info.sampleCount;
+    storedBytes += r.len;
+  }
+
+  fprintf(stderr, "blocks=%lu samples=%lu bad=%lu ratio(vs int16)=%.2f\n",
+          blocks, samples, badBlocks,
+          storedBytes ? (samples * 6.0) / (double)storedBytes : 0.0);
+  return badBlocks ? 1 : 0;
+}